@@ -0,0 +1,149 @@
+// Loopback benchmark for the binary order entry gateway.
+//
+//   order_entry_bench [orders] [host port]
+//
+// Without a host it starts a gateway on a free local port in front of its own
+// Exchange. Orders alternate between a resting buy and a sell that fills it,
+// so the book stays empty and every other order matches. Reports round trip
+// latency (send to Ack) one order at a time, then pipelined throughput.
+
+#include "OrderEntryClient.h"
+#include "OrderEntryGateway.h"
+#include "Exchange.h"
+#include "Clock.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace velocore;
+
+namespace {
+
+const std::string BENCH_SYMBOL = "BENCH";
+
+// Orders sent back to back before reading their Acks in the pipelined run
+constexpr size_t PIPELINE_DEPTH = 64;
+
+struct Counts {
+    size_t acks = 0;
+    size_t fills = 0;
+    size_t rejects = 0;
+};
+
+// Reads until the next Ack or Reject, counting the fills on the way
+void awaitAck(OrderEntryClient& client, Counts& counts) {
+    while (true) {
+        OrderEntryClient::Response response = client.receive();
+        if (std::holds_alternative<FillMessage>(response)) {
+            counts.fills++;
+            continue;
+        }
+        if (std::holds_alternative<AckMessage>(response)) {
+            counts.acks++;
+        } else {
+            counts.rejects++;
+        }
+        return;
+    }
+}
+
+void sendOrder(OrderEntryClient& client, size_t n, Price price) {
+    client.sendNewOrder(BENCH_SYMBOL, n % 2 == 0 ? Side::Buy : Side::Sell, OrderType::Limit, price, 1);
+}
+
+double percentile(const std::vector<int64_t>& sorted, double fraction) {
+    size_t index = static_cast<size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t orders = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    orders = std::max<size_t>(orders - orders % 2, 2);
+
+    Logger::instance().setLevel(LogLevel::Warn);
+
+    std::unique_ptr<Exchange> exchange;
+    std::unique_ptr<OrderEntryGateway> gateway;
+    std::string host = "127.0.0.1";
+    uint16_t port = 0;
+
+    if (argc > 3) {
+        host = argv[2];
+        port = static_cast<uint16_t>(std::atoi(argv[3]));
+    } else {
+        exchange = std::make_unique<Exchange>();
+        exchange->getOrCreateBook(intern_symbol(BENCH_SYMBOL));
+        OrderEntryGateway::Handlers handlers;
+        handlers.findSymbol = [&](const std::string& symbol) { return exchange->findListedSymbol(symbol); };
+        handlers.submitOrder = [&](const Order& order) { return exchange->addOrder(order); };
+        handlers.submitCancel = [&](SymbolId symbol, uint64_t orderId) { return exchange->cancelOrder(symbol, orderId); };
+        handlers.submitAmend = [&](SymbolId symbol, uint64_t orderId, Price newPrice, int newQuantity) {
+            return exchange->amendOrder(symbol, orderId, newPrice, newQuantity);
+        };
+        handlers.findOrder = [&](SymbolId symbol, uint64_t orderId) -> std::optional<Order> {
+            OrderBook* book = exchange->findBook(symbol);
+            return book ? book->findOrder(orderId) : std::nullopt;
+        };
+        gateway = std::make_unique<OrderEntryGateway>(std::move(handlers));
+        gateway->start(0);
+        port = gateway->port();
+    }
+
+    OrderEntryClient client;
+    client.connect(host, port);
+    Price price = Price::from_double(100.0, tick_size_for(BENCH_SYMBOL));
+    Counts counts;
+
+    // Warm up the connection, the book and the allocator
+    for (size_t n = 0; n < std::min<size_t>(orders, 10000); ++n) {
+        sendOrder(client, n, price);
+        awaitAck(client, counts);
+    }
+
+    std::vector<int64_t> latencies;
+    latencies.reserve(orders);
+    counts = Counts{};
+    for (size_t n = 0; n < orders; ++n) {
+        Clock::time_point start = Clock::now();
+        sendOrder(client, n, price);
+        awaitAck(client, counts);
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::printf("Round trip, one order at a time (%zu orders, %zu fills, %zu rejects)\n",
+                orders, counts.fills, counts.rejects);
+    std::printf("  p50 %.1f us  p99 %.1f us  p99.9 %.1f us  max %.1f us\n",
+                percentile(latencies, 0.50), percentile(latencies, 0.99),
+                percentile(latencies, 0.999), percentile(latencies, 1.0));
+
+    counts = Counts{};
+    Clock::time_point start = Clock::now();
+    for (size_t sent = 0; sent < orders; sent += PIPELINE_DEPTH) {
+        size_t batch = std::min(PIPELINE_DEPTH, orders - sent);
+        for (size_t n = 0; n < batch; ++n) {
+            sendOrder(client, sent + n, price);
+        }
+        for (size_t n = 0; n < batch; ++n) {
+            awaitAck(client, counts);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::printf("Pipelined, %zu in flight (%zu orders, %zu rejects)\n", PIPELINE_DEPTH, orders, counts.rejects);
+    std::printf("  %.0f orders/s\n", static_cast<double>(orders) / seconds);
+
+    client.close();
+    if (gateway) {
+        gateway->stop();
+    }
+    return 0;
+}
@@ -30,6 +30,13 @@ public:
         int server_port = 8080;
         std::string log_level = "INFO";
         bool debug_mode = false;
+        bool sequencer_mode = false;     // Route order entry through the single matching thread
+        int matching_thread_cpu = -1;    // Core to pin the matching thread to, -1 for none
+        size_t trade_log_capacity = 65536;   // Recent trades each book keeps in memory
+        std::string trade_log_spill_dir = "";  // Where older trades are written, empty to drop them
+        std::string symbols = "SIM";     // Comma-separated tickers that can be traded
+        int order_entry_port = 0;        // Binary order entry gateway port, 0 to disable
+        std::string order_entry_address = "127.0.0.1";  // Unauthenticated, so loopback unless trusted
     };
 
     static Configuration& getInstance() {
@@ -38,6 +45,47 @@ public:
     }
 
     void loadFromEnvironment() {
+        // Load general configuration first so it applies even without Alpaca credentials
+        if (const char* port = std::getenv("SERVER_PORT")) {
+            general_.server_port = std::stoi(port);
+        }
+        
+        if (const char* log_level = std::getenv("LOG_LEVEL")) {
+            general_.log_level = log_level;
+        }
+        
+        if (const char* debug = std::getenv("DEBUG_MODE")) {
+            general_.debug_mode = (std::string(debug) == "true");
+        }
+        
+        if (const char* sequencer = std::getenv("SEQUENCER_MODE")) {
+            general_.sequencer_mode = (std::string(sequencer) == "true");
+        }
+        
+        if (const char* cpu = std::getenv("MATCHING_THREAD_CPU")) {
+            general_.matching_thread_cpu = std::stoi(cpu);
+        }
+        
+        if (const char* capacity = std::getenv("TRADE_LOG_CAPACITY")) {
+            general_.trade_log_capacity = std::stoul(capacity);
+        }
+        
+        if (const char* spill_dir = std::getenv("TRADE_LOG_SPILL_DIR")) {
+            general_.trade_log_spill_dir = spill_dir;
+        }
+        
+        if (const char* symbols = std::getenv("SYMBOLS")) {
+            general_.symbols = symbols;
+        }
+        
+        if (const char* order_entry_port = std::getenv("ORDER_ENTRY_PORT")) {
+            general_.order_entry_port = std::stoi(order_entry_port);
+        }
+        
+        if (const char* order_entry_address = std::getenv("ORDER_ENTRY_ADDRESS")) {
+            general_.order_entry_address = order_entry_address;
+        }
+        
         // Load Alpaca configuration from environment variables
         alpaca_.api_key = getEnvVar("ALPACA_API_KEY");
         alpaca_.api_secret = getEnvVar("ALPACA_API_SECRET");
@@ -54,19 +102,6 @@ public:
         if (const char* is_paper = std::getenv("ALPACA_PAPER_TRADING")) {
             alpaca_.is_paper_trading = (std::string(is_paper) == "true");
         }
-        
-        // Load other configuration
-        if (const char* port = std::getenv("SERVER_PORT")) {
-            general_.server_port = std::stoi(port);
-        }
-        
-        if (const char* log_level = std::getenv("LOG_LEVEL")) {
-            general_.log_level = log_level;
-        }
-        
-        if (const char* debug = std::getenv("DEBUG_MODE")) {
-            general_.debug_mode = (std::string(debug) == "true");
-        }
     }
 
     const AlpacaConfig& getAlpacaConfig() const { return alpaca_; }
@@ -1,13 +1,26 @@
 #include "MarketDataFeed.h"
+#include "Logger.h"
 #include <boost/beast/websocket/ssl.hpp>
 #include <boost/asio/connect.hpp>
 #include <boost/asio/ssl.hpp>
-#include <iostream>
 #include <sstream>
 #include <set>
 
 namespace velocore {
 
+namespace {
+
+// Interns a message's "S" (symbol) field straight from the parsed JSON, without copying it out
+SymbolId symbolField(const nlohmann::json& data) {
+    auto it = data.find("S");
+    if (it == data.end() || !it->is_string()) {
+        return SymbolId();
+    }
+    return intern_symbol(it->get_ref<const std::string&>());
+}
+
+} // namespace
+
 MarketDataFeed::MarketDataFeed() 
     : config_(Configuration::getInstance()),
       ssl_context_(boost::asio::ssl::context::tlsv12_client),
@@ -18,7 +31,7 @@ MarketDataFeed::MarketDataFeed()
     // In MarketDataFeed constructor
     if (std::getenv("DISABLE_SSL_VERIFY") && std::string(std::getenv("DISABLE_SSL_VERIFY")) == "true") {
         ssl_context_.set_verify_mode(boost::asio::ssl::verify_none);
-        std::cout << "SSL verification disabled for development" << std::endl;
+        log_warn("SSL verification disabled for development");
     } else {
         ssl_context_.set_verify_mode(boost::asio::ssl::verify_peer);
     }
@@ -37,7 +50,7 @@ void MarketDataFeed::start() {
         return;
     }
     
-    std::cout << "Starting MarketDataFeed..." << std::endl;
+    log_info("Starting MarketDataFeed...");
     
     worker_thread_ = std::thread([this]() {
         connectWebSocket();
@@ -50,7 +63,7 @@ void MarketDataFeed::stop() {
         return;
     }
     
-    std::cout << "Stopping MarketDataFeed..." << std::endl;
+    log_info("Stopping MarketDataFeed...");
     
     // Stop timers
     if (heartbeat_timer_) {
@@ -81,14 +94,14 @@ void MarketDataFeed::subscribe(const std::string& symbol, bool trades, bool quot
     
     // Check if already subscribed
     if (subscribed_symbols_.find(symbol) != subscribed_symbols_.end()) {
-        std::cout << "Already subscribed to " << symbol << std::endl;
+        log_debug("Already subscribed to ", symbol);
         return;
     }
     
     // Check if already in pending subscriptions
     for (const auto& pending : pending_subscriptions_) {
         if (pending.symbol == symbol) {
-            std::cout << "Subscription for " << symbol << " already pending" << std::endl;
+            log_debug("Subscription for ", symbol, " already pending");
             return;
         }
     }
@@ -109,7 +122,7 @@ void MarketDataFeed::subscribe(const std::string& symbol, bool trades, bool quot
         });
     }
     
-    std::cout << "Queued subscription for " << symbol << std::endl;
+    log_info("Queued subscription for ", symbol);
 }
 
 void MarketDataFeed::unsubscribe(const std::string& symbol) {
@@ -117,7 +130,7 @@ void MarketDataFeed::unsubscribe(const std::string& symbol) {
     
     // Check if actually subscribed
     if (subscribed_symbols_.find(symbol) == subscribed_symbols_.end()) {
-        std::cout << "Not subscribed to " << symbol << std::endl;
+        log_debug("Not subscribed to ", symbol);
         return;
     }
     
@@ -139,7 +152,7 @@ void MarketDataFeed::unsubscribe(const std::string& symbol) {
         });
     }
     
-    std::cout << "Unsubscribed from " << symbol << std::endl;
+    log_info("Unsubscribed from ", symbol);
 }
 
 void MarketDataFeed::onTick(OnTickCallback callback) {
@@ -166,7 +179,7 @@ std::vector<std::string> MarketDataFeed::getSubscribedSymbols() const {
     return std::vector<std::string>(subscribed_symbols_.begin(), subscribed_symbols_.end());
 }
 
-void MarketDataFeed::broadcastBookUpdate(const std::string& symbol, const MarketTick& tick) {
+void MarketDataFeed::broadcastBookUpdate(SymbolId symbol, const MarketTick& tick) {
     (void)symbol; // Mark as unused to suppress warning
     std::lock_guard<std::mutex> lock(callback_mutex_);
     if (tick_callback_) {
@@ -176,7 +189,7 @@ void MarketDataFeed::broadcastBookUpdate(const std::string& symbol, const Market
 
 void MarketDataFeed::connectWebSocket() {
     try {
-        std::cout << "Connecting to Alpaca WebSocket..." << std::endl;
+        log_info("Connecting to Alpaca WebSocket...");
         
         // Parse configured URL
         std::string url = config_.getAlpacaConfig().data_url;
@@ -187,7 +200,7 @@ void MarketDataFeed::connectWebSocket() {
             throw std::runtime_error("Invalid WebSocket URL: " + url);
         }
         
-        std::cout << "Connecting to " << host << ":" << port << path << " (secure: " << is_secure << ")" << std::endl;
+        log_info("Connecting to ", host, ":", port, path, " (secure: ", is_secure, ")");
         
         // Create WebSocket stream
         ws_ = std::make_unique<boost::beast::websocket::stream<
@@ -230,7 +243,7 @@ void MarketDataFeed::onConnect(boost::beast::error_code ec, boost::asio::ip::tcp
         return;
     }
     
-    std::cout << "TCP connection established, starting SSL handshake..." << std::endl;
+    log_info("TCP connection established, starting SSL handshake...");
     
     // Perform SSL handshake
     ws_->next_layer().async_handshake(
@@ -246,7 +259,7 @@ void MarketDataFeed::onHandshake(boost::beast::error_code ec) {
         return;
     }
     
-    std::cout << "SSL handshake successful, upgrading to WebSocket..." << std::endl;
+    log_info("SSL handshake successful, upgrading to WebSocket...");
     
     // Set WebSocket options
     ws_->set_option(boost::beast::websocket::stream_base::timeout::suggested(
@@ -268,7 +281,7 @@ void MarketDataFeed::onHandshake(boost::beast::error_code ec) {
                 return;
             }
             
-            std::cout << "WebSocket connection established!" << std::endl;
+            log_info("WebSocket connection established!");
             
             updateConnectionStatus(true);
             reconnect_attempts_ = 0;
@@ -296,14 +309,14 @@ void MarketDataFeed::authenticateConnection() {
     auth_msg["secret"] = alpaca_config.api_secret;
     
     std::string auth_str = auth_msg.dump();
-    std::cout << "Sending authentication..." << std::endl;
+    log_info("Sending authentication...");
     
     sendMessage(auth_str);
 }
 
 void MarketDataFeed::sendMessage(const std::string& message) {
     if (!connected_) {
-        std::cout << "Cannot send message: not connected" << std::endl;
+        log_warn("Cannot send message: not connected");
         return;
     }
     
@@ -323,7 +336,7 @@ void MarketDataFeed::onWrite(boost::beast::error_code ec, std::size_t bytes_tran
         return;
     }
     
-    std::cout << "Sent " << bytes_transferred << " bytes" << std::endl;
+    log_debug("Sent ", bytes_transferred, " bytes");
 }
 
 void MarketDataFeed::onRead(boost::beast::error_code ec, std::size_t bytes_transferred) {
@@ -360,8 +373,8 @@ void MarketDataFeed::handleMessage(const std::string& message) {
         }
         
     } catch (const std::exception& e) {
-        std::cout << "Failed to parse message: " << e.what() << std::endl;
-        std::cout << "Message: " << message << std::endl;
+        log_error("Failed to parse message: ", e.what());
+        log_error("Message: ", message);
     }
 }
 
@@ -378,14 +391,14 @@ void MarketDataFeed::handleSingleMessage(const nlohmann::json& msg) {
     if (msg_type == "success" && msg.contains("msg")) {
         std::string success_msg = msg["msg"];
         if (success_msg == "authenticated") {
-            std::cout << "Successfully authenticated!" << std::endl;
+            log_info("Successfully authenticated!");
             authenticated_ = true;
             // Send pending subscriptions now that we're authenticated
             sendSubscriptionMessage();
             // Start heartbeat monitoring
             startHeartbeat();
         } else if (success_msg == "connected") {
-            std::cout << "Successfully connected to Alpaca WebSocket!" << std::endl;
+            log_info("Successfully connected to Alpaca WebSocket!");
             // Connection established, authentication should be sent automatically
         }
     } else if (msg_type == "subscription") {
@@ -408,12 +421,12 @@ void MarketDataFeed::handleSingleMessage(const nlohmann::json& msg) {
     } else if (msg_type == "t" || msg_type == "q" || msg_type == "b" || msg_type == "d" || msg_type == "u") {
         // Market data message types:
         // t = trade, q = quote, b = minute bar, d = daily bar, u = updated bar
-        std::cout << "Received market data: " << msg_type << " for " << msg.value("S", "unknown") << std::endl;
+        log_debug("Received market data: ", msg_type, " for ", msg.value("S", "unknown"));
         nlohmann::json array_msg = nlohmann::json::array({msg});
         parseMarketData(array_msg);
     } else {
         // Log unknown message types for debugging
-        std::cout << "Received message type: " << msg_type << " - " << msg.dump() << std::endl;
+        log_debug("Received message type: ", msg_type, " - ", msg.dump());
     }
 }
 
@@ -448,7 +461,7 @@ void MarketDataFeed::sendSubscriptionMessage() {
     if (!bars.empty()) sub_msg["bars"] = bars;
     
     std::string sub_str = sub_msg.dump();
-    std::cout << "Sending subscription: " << sub_str << std::endl;
+    log_info("Sending subscription: ", sub_str);
     
     sendMessage(sub_str);
 }
@@ -516,11 +529,11 @@ void MarketDataFeed::processSubscriptionAck(const nlohmann::json& message) {
         }
     }
     
-    std::cout << "Subscription acknowledged for symbols: ";
+    std::string symbol_list;
     for (const auto& sym : unique_symbols) {
-        std::cout << sym << " ";
+        symbol_list += sym + " ";
     }
-    std::cout << std::endl;
+    log_info("Subscription acknowledged for symbols: ", symbol_list);
     
     // Clear pending subscriptions since they've been processed
     pending_subscriptions_.clear();
@@ -538,29 +551,29 @@ void MarketDataFeed::parseMarketData(const nlohmann::json& message) {
                         // Trade message
                         MarketTick tick = parseTradeMessage(item);
                         if (!tick.symbol.empty()) {
-                            std::cout << "Broadcasting trade: " << tick.symbol << " @ $" << tick.trade_price << " x " << tick.trade_size << std::endl;
+                            log_debug("Broadcasting trade: ", tick.symbol, " @ $", tick.trade_price, " x ", tick.trade_size);
                             broadcastBookUpdate(tick.symbol, tick);
                         }
                     } else if (msg_type == "q") {
                         // Quote message
                         MarketTick tick = parseQuoteMessage(item);
                         if (!tick.symbol.empty()) {
-                            std::cout << "Broadcasting quote: " << tick.symbol << " bid $" << tick.bid_price << " ask $" << tick.ask_price << std::endl;
+                            log_debug("Broadcasting quote: ", tick.symbol, " bid $", tick.bid_price, " ask $", tick.ask_price);
                             broadcastBookUpdate(tick.symbol, tick);
                         }
                     } else if (msg_type == "b" || msg_type == "d" || msg_type == "u") {
                         // Bar message (minute bars, daily bars, updated bars)
                         MarketTick tick = parseBarMessage(item);
                         if (!tick.symbol.empty()) {
-                            std::cout << "Broadcasting bar: " << tick.symbol << " close $" << tick.close << std::endl;
+                            log_debug("Broadcasting bar: ", tick.symbol, " close $", tick.close);
                             broadcastBookUpdate(tick.symbol, tick);
                         }
                     } else {
-                        std::cout << "Unknown market data message type: " << msg_type << std::endl;
+                        log_warn("Unknown market data message type: ", msg_type);
                     }
                 } catch (const std::exception& e) {
-                    std::cout << "Error parsing market data message: " << e.what() << std::endl;
-                    std::cout << "Message: " << item.dump() << std::endl;
+                    log_error("Error parsing market data message: ", e.what());
+                    log_error("Message: ", item.dump());
                 }
             }
         }
@@ -572,10 +585,10 @@ MarketTick MarketDataFeed::parseTradeMessage(const nlohmann::json& trade_data) {
     tick.type = MarketDataType::Trade;
     
     // Required fields
-    tick.symbol = trade_data.value("S", "");
+    tick.symbol = symbolField(trade_data);
     tick.trade_price = trade_data.value("p", 0.0);
     tick.trade_size = trade_data.value("s", 0);
-    tick.timestamp = std::chrono::steady_clock::now();
+    tick.timestamp = Clock::now();
     
     return tick;
 }
@@ -585,12 +598,12 @@ MarketTick MarketDataFeed::parseQuoteMessage(const nlohmann::json& quote_data) {
     tick.type = MarketDataType::Quote;
     
     // Required fields
-    tick.symbol = quote_data.value("S", "");
+    tick.symbol = symbolField(quote_data);
     tick.bid_price = quote_data.value("bp", 0.0);
     tick.ask_price = quote_data.value("ap", 0.0);
     tick.bid_size = quote_data.value("bs", 0);
     tick.ask_size = quote_data.value("as", 0);
-    tick.timestamp = std::chrono::steady_clock::now();
+    tick.timestamp = Clock::now();
     
     return tick;
 }
@@ -599,13 +612,13 @@ MarketTick MarketDataFeed::parseBarMessage(const nlohmann::json& bar_data) {
     MarketTick tick;
     tick.type = MarketDataType::Bar;
     
-    tick.symbol = bar_data.value("S", "");
+    tick.symbol = symbolField(bar_data);
     tick.open = bar_data.value("o", 0.0);
     tick.high = bar_data.value("h", 0.0);
     tick.low = bar_data.value("l", 0.0);
     tick.close = bar_data.value("c", 0.0);
     tick.volume = bar_data.value("v", 0);
-    tick.timestamp = std::chrono::steady_clock::now();
+    tick.timestamp = Clock::now();
     
     return tick;
 }
@@ -626,8 +639,7 @@ void MarketDataFeed::scheduleReconnect() {
     reconnect_attempts_++;
     int delay = md_config.reconnect_delay_ms * reconnect_attempts_;
     
-    std::cout << "Scheduling reconnect in " << delay << "ms (attempt " 
-              << reconnect_attempts_ << ")" << std::endl;
+    log_warn("Scheduling reconnect in ", delay, "ms (attempt ", reconnect_attempts_.load(), ")");
     
     reconnect_timer_->expires_after(std::chrono::milliseconds(delay));
     reconnect_timer_->async_wait([this](boost::beast::error_code ec) {
@@ -649,7 +661,7 @@ void MarketDataFeed::updateConnectionStatus(bool connected) {
 }
 
 void MarketDataFeed::reportError(const std::string& error) {
-    std::cout << "MarketDataFeed Error: " << error << std::endl;
+    log_error("MarketDataFeed Error: ", error);
     
     std::lock_guard<std::mutex> lock(callback_mutex_);
     if (error_callback_) {
@@ -668,9 +680,9 @@ void MarketDataFeed::closeWebSocket() {
 
 void MarketDataFeed::onClose(boost::beast::error_code ec) {
     if (ec) {
-        std::cout << "Close failed: " << ec.message() << std::endl;
+        log_error("Close failed: ", ec.message());
     } else {
-        std::cout << "WebSocket connection closed" << std::endl;
+        log_info("WebSocket connection closed");
     }
     
     updateConnectionStatus(false);
@@ -687,7 +699,7 @@ void MarketDataFeed::sendUnsubscriptionMessage(const std::string& symbol) {
     unsub_msg["bars"] = {symbol};
     
     std::string unsub_str = unsub_msg.dump();
-    std::cout << "Sending unsubscription for " << symbol << ": " << unsub_str << std::endl;
+    log_info("Sending unsubscription for ", symbol, ": ", unsub_str);
     
     sendMessage(unsub_str);
 }
@@ -780,7 +792,7 @@ void MarketDataFeed::handleHeartbeat() {
     
     // Check if we haven't received any messages in too long
     if (time_since_last_message > (md_config.heartbeat_interval_ms * 2)) {
-        std::cout << "Heartbeat timeout - no messages received for " << time_since_last_message << "ms" << std::endl;
+        log_warn("Heartbeat timeout - no messages received for ", time_since_last_message, "ms");
         reportError("Heartbeat timeout - connection may be stale");
         scheduleReconnect();
         return;
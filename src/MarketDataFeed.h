@@ -45,7 +45,7 @@ public:
     std::vector<std::string> getSubscribedSymbols() const;
     
     // Broadcast method for system integration
-    void broadcastBookUpdate(const std::string& symbol, const MarketTick& tick);
+    void broadcastBookUpdate(SymbolId symbol, const MarketTick& tick);
 
 private:
     // WebSocket connection management
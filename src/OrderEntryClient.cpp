@@ -0,0 +1,109 @@
+#include "OrderEntryClient.h"
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <stdexcept>
+
+namespace velocore {
+
+using boost::asio::ip::tcp;
+
+OrderEntryClient::OrderEntryClient() : socket(ioContext) {}
+
+OrderEntryClient::~OrderEntryClient() {
+    close();
+}
+
+void OrderEntryClient::connect(const std::string& host, uint16_t port) {
+    tcp::resolver resolver(ioContext);
+    boost::asio::connect(socket, resolver.resolve(host, std::to_string(port)));
+    socket.set_option(tcp::no_delay(true));
+    nextClientOrderId = 1;
+}
+
+void OrderEntryClient::close() {
+    if (socket.is_open()) {
+        boost::system::error_code ec;
+        socket.shutdown(tcp::socket::shutdown_both, ec);
+        socket.close(ec);
+    }
+}
+
+template<typename Message>
+void OrderEntryClient::send(const Message& message) {
+    uint8_t buffer[Message::SIZE];
+    encode(message, buffer);
+    boost::asio::write(socket, boost::asio::buffer(buffer, Message::SIZE));
+}
+
+uint64_t OrderEntryClient::sendNewOrder(const std::string& symbol, Side side, OrderType type, Price price,
+                                        uint32_t quantity) {
+    NewOrderMessage message;
+    message.client_order_id = nextClientOrderId;
+    message.symbol = symbol;
+    message.side = side;
+    message.type = type;
+    message.quantity = quantity;
+    message.price = price;
+    send(message);
+    return nextClientOrderId++;
+}
+
+uint64_t OrderEntryClient::sendCancel(uint64_t orderId) {
+    CancelMessage message;
+    message.client_order_id = nextClientOrderId;
+    message.order_id = orderId;
+    send(message);
+    return nextClientOrderId++;
+}
+
+uint64_t OrderEntryClient::sendAmend(uint64_t orderId, Price newPrice, uint32_t newQuantity) {
+    AmendMessage message;
+    message.client_order_id = nextClientOrderId;
+    message.order_id = orderId;
+    message.quantity = newQuantity;
+    message.price = newPrice;
+    send(message);
+    return nextClientOrderId++;
+}
+
+OrderEntryClient::Response OrderEntryClient::receive() {
+    uint8_t message[ORDER_ENTRY_MAX_MESSAGE_SIZE];
+    boost::asio::read(socket, boost::asio::buffer(message, ORDER_ENTRY_HEADER_SIZE));
+
+    OrderEntryHeader header;
+    if (!decode_header(message, header)) {
+        throw std::runtime_error("Malformed order entry message header");
+    }
+    boost::asio::read(socket, boost::asio::buffer(message + ORDER_ENTRY_HEADER_SIZE, header.length - ORDER_ENTRY_HEADER_SIZE));
+
+    switch (header.type) {
+        case OrderEntryMessageType::Ack: {
+            AckMessage ack;
+            if (decode(message, ack)) {
+                return ack;
+            }
+            break;
+        }
+        case OrderEntryMessageType::Fill: {
+            FillMessage fill;
+            if (decode(message, fill)) {
+                return fill;
+            }
+            break;
+        }
+        case OrderEntryMessageType::Reject: {
+            RejectMessage reject;
+            if (decode(message, reject)) {
+                return reject;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    throw std::runtime_error("Unexpected order entry message");
+}
+
+} // namespace velocore
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/io_context.hpp>
+#include <cstdint>
+#include <string>
+#include <variant>
+
+#include "OrderEntryProtocol.h"
+
+namespace velocore {
+
+/**
+ * OrderEntryClient - Blocking client for one OrderEntryGateway session.
+ *
+ * Requests are encoded on the stack and sent with one write each, with
+ * Nagle disabled. Client order ids are assigned from 1 per connection.
+ * One thread may send while another receives; neither side is safe to
+ * call from several threads at once.
+ */
+class OrderEntryClient {
+public:
+    using Response = std::variant<AckMessage, FillMessage, RejectMessage>;
+
+    OrderEntryClient();
+    ~OrderEntryClient();
+
+    OrderEntryClient(const OrderEntryClient&) = delete;
+    OrderEntryClient& operator=(const OrderEntryClient&) = delete;
+
+    /**
+     * Opens a session
+     * @throws boost::system::system_error if the host cannot be resolved or reached
+     */
+    void connect(const std::string& host, uint16_t port);
+
+    void close();
+
+    bool isConnected() const { return socket.is_open(); }
+
+    /**
+     * Sends a NewOrder
+     * @param price Limit price in ticks of the symbol's tick size, ignored for market orders
+     * @return The client order id the responses will carry
+     * @throws std::invalid_argument if the symbol does not fit the message
+     * @throws boost::system::system_error if the session is broken
+     */
+    uint64_t sendNewOrder(const std::string& symbol, Side side, OrderType type, Price price, uint32_t quantity);
+
+    /**
+     * Sends a Cancel for an order this session entered
+     * @return The client order id of the request
+     */
+    uint64_t sendCancel(uint64_t orderId);
+
+    /**
+     * Sends an Amend for an order this session entered
+     * @param newPrice New limit price in ticks, 0 to keep the current one
+     * @param newQuantity New total quantity, 0 to keep the current one
+     * @return The client order id of the request
+     */
+    uint64_t sendAmend(uint64_t orderId, Price newPrice, uint32_t newQuantity);
+
+    /**
+     * Waits for the next message from the gateway
+     * @throws boost::system::system_error if the session is closed
+     * @throws std::runtime_error if the gateway sends something that is not a response
+     */
+    Response receive();
+
+private:
+    template<typename Message>
+    void send(const Message& message);
+
+    boost::asio::io_context ioContext;
+    boost::asio::ip::tcp::socket socket;
+    uint64_t nextClientOrderId = 1;
+};
+
+} // namespace velocore
@@ -0,0 +1,614 @@
+#include "OrderEntryGateway.h"
+#include "Logger.h"
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/write.hpp>
+#include <algorithm>
+#include <climits>
+
+namespace velocore {
+
+using boost::asio::ip::tcp;
+
+struct OrderEntryGateway::Session : std::enable_shared_from_this<Session> {
+    Session(boost::asio::io_context& ioContext, size_t maxQueuedBytes)
+        : strand(boost::asio::make_strand(ioContext)), socket(strand), maxQueuedBytes(maxQueuedBytes) {}
+
+    // The socket completes on the strand, so reads, handling and writes never overlap
+    boost::asio::strand<boost::asio::io_context::executor_type> strand;
+    tcp::socket socket;
+    uint64_t id = 0;
+    std::atomic<bool> open{true};
+    uint8_t message[ORDER_ENTRY_MAX_MESSAGE_SIZE];
+
+    // Guards output, inFlight and the flags below. Never held across socket I/O,
+    // so taking it only ever waits for another thread to queue its messages.
+    std::mutex outputMutex;
+    std::vector<uint8_t> output;
+    std::vector<uint8_t> inFlight;
+    bool writing = false;
+    bool closeWhenSent = false;
+    const size_t maxQueuedBytes;
+
+    template<typename Message>
+    void append(const Message& message) {
+        if (!open) {
+            return;
+        }
+        size_t offset = output.size();
+        output.resize(offset + Message::SIZE);
+        encode(message, output.data() + offset);
+    }
+
+    // Hands everything appended to the strand to write; call with outputMutex held
+    void flush() {
+        if (output.empty() || !open) {
+            return;
+        }
+        if (output.size() + inFlight.size() > maxQueuedBytes) {
+            log_warn("Order entry session ", id, " is not reading its responses, disconnecting");
+            output.clear();
+            close();
+            return;
+        }
+        if (!writing) {
+            writing = true;
+            boost::asio::post(strand, [self = shared_from_this()]() { self->writeNext(); });
+        }
+    }
+
+    // Runs on the strand; writes whatever was queued meanwhile once each write completes
+    void writeNext() {
+        {
+            std::lock_guard<std::mutex> lock(outputMutex);
+            if (output.empty() || !open) {
+                writing = false;
+                if (closeWhenSent) {
+                    close();
+                }
+                return;
+            }
+            inFlight.swap(output);
+        }
+        boost::asio::async_write(socket, boost::asio::buffer(inFlight),
+                                 [self = shared_from_this()](const boost::system::error_code& ec, size_t) {
+            {
+                std::lock_guard<std::mutex> lock(self->outputMutex);
+                self->inFlight.clear();
+            }
+            if (ec) {
+                // The pending read fails too and reports the disconnect
+                self->close();
+            }
+            self->writeNext();
+        });
+    }
+
+    // Safe from any thread; the socket itself is only touched on the strand
+    void close() {
+        open = false;
+        boost::asio::post(strand, [self = shared_from_this()]() {
+            boost::system::error_code ec;
+            self->socket.shutdown(tcp::socket::shutdown_both, ec);
+            self->socket.close(ec);
+        });
+    }
+};
+
+namespace {
+
+// Handlers may wait on the matching thread, so a few threads keep other sessions moving meanwhile
+constexpr unsigned MIN_IO_THREADS = 2;
+constexpr unsigned MAX_IO_THREADS = 4;
+
+uint32_t executedQuantity(uint64_t orderId, const std::vector<Trade>& trades) {
+    uint32_t executed = 0;
+    for (const auto& trade : trades) {
+        if (trade.buy_order_id == orderId || trade.sell_order_id == orderId) {
+            executed += static_cast<uint32_t>(trade.quantity);
+        }
+    }
+    return executed;
+}
+
+RejectMessage makeReject(OrderEntryMessageType request, uint64_t clientOrderId, uint64_t orderId,
+                         RejectReason reason) {
+    RejectMessage reject;
+    reject.client_order_id = clientOrderId;
+    reject.order_id = orderId;
+    reject.request = request;
+    reject.reason = reason;
+    return reject;
+}
+
+} // namespace
+
+OrderEntryGateway::OrderEntryGateway(Handlers handlers, size_t maxQueuedBytes)
+    : handlers(std::move(handlers)), maxQueuedBytes(maxQueuedBytes) {}
+
+OrderEntryGateway::~OrderEntryGateway() {
+    stop();
+}
+
+void OrderEntryGateway::start(uint16_t port, const std::string& address) {
+    acceptor = std::make_unique<tcp::acceptor>(ioContext, tcp::endpoint(boost::asio::ip::make_address(address), port));
+    boundPort = acceptor->local_endpoint().port();
+    running = true;
+
+    acceptNext();
+    unsigned threadCount = std::clamp(std::thread::hardware_concurrency(), MIN_IO_THREADS, MAX_IO_THREADS);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        ioThreads.emplace_back([this]() { ioContext.run(); });
+    }
+    log_info("Order entry gateway listening on ", address, ":", boundPort);
+}
+
+void OrderEntryGateway::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    ioContext.stop();
+    for (auto& thread : ioThreads) {
+        thread.join();
+    }
+    ioThreads.clear();
+    boost::system::error_code ec;
+    acceptor->close(ec);
+
+    std::vector<std::shared_ptr<Session>> closing;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        closing.swap(sessions);
+    }
+    // With the I/O threads gone nothing else touches the sockets
+    for (auto& session : closing) {
+        session->open = false;
+        session->socket.shutdown(tcp::socket::shutdown_both, ec);
+        session->socket.close(ec);
+    }
+    log_info("Order entry gateway stopped");
+}
+
+void OrderEntryGateway::acceptNext() {
+    auto session = std::make_shared<Session>(ioContext, maxQueuedBytes);
+    acceptor->async_accept(session->socket, [this, session](const boost::system::error_code& ec) {
+        if (!running) {
+            return;
+        }
+        if (ec) {
+            log_warn("Order entry accept failed: ", ec.message());
+        } else {
+            boost::system::error_code optionError;
+            session->socket.set_option(tcp::no_delay(true), optionError);
+            {
+                std::lock_guard<std::mutex> lock(sessionsMutex);
+                // Forget sessions that have disconnected
+                sessions.erase(std::remove_if(sessions.begin(), sessions.end(),
+                                              [](const auto& s) { return !s->open.load(); }),
+                               sessions.end());
+                session->id = nextSessionId++;
+                sessions.push_back(session);
+            }
+
+            tcp::endpoint remote = session->socket.remote_endpoint(optionError);
+            log_info("Order entry session ", session->id, " connected from ", remote.address().to_string(), ":",
+                     remote.port());
+            readHeader(session);
+        }
+        acceptNext();
+    });
+}
+
+void OrderEntryGateway::readHeader(const std::shared_ptr<Session>& session) {
+    boost::asio::async_read(session->socket, boost::asio::buffer(session->message, ORDER_ENTRY_HEADER_SIZE),
+                            [this, session](const boost::system::error_code& ec, size_t) {
+        if (ec) {
+            session->close();
+            log_info("Order entry session ", session->id, " disconnected");
+            return;
+        }
+
+        OrderEntryHeader header;
+        if (!decode_header(session->message, header)) {
+            // Without a trustworthy length the next message cannot be found, so the session ends
+            log_warn("Order entry session ", session->id, " sent a malformed header, disconnecting");
+            std::lock_guard<std::mutex> lock(session->outputMutex);
+            session->append(makeReject(OrderEntryMessageType::NewOrder, 0, 0, RejectReason::InvalidMessage));
+            session->closeWhenSent = true;
+            session->flush();
+            return;
+        }
+        readBody(session, header);
+    });
+}
+
+void OrderEntryGateway::readBody(const std::shared_ptr<Session>& session, const OrderEntryHeader& header) {
+    boost::asio::async_read(session->socket,
+                            boost::asio::buffer(session->message + ORDER_ENTRY_HEADER_SIZE,
+                                                header.length - ORDER_ENTRY_HEADER_SIZE),
+                            [this, session, header](const boost::system::error_code& ec, size_t) {
+        if (ec) {
+            session->close();
+            log_info("Order entry session ", session->id, " disconnected");
+            return;
+        }
+        handleMessage(*session, header);
+        readHeader(session);
+    });
+}
+
+void OrderEntryGateway::handleMessage(Session& session, const OrderEntryHeader& header) {
+    bool valid = false;
+    switch (header.type) {
+        case OrderEntryMessageType::NewOrder: {
+            NewOrderMessage request;
+            if ((valid = decode(session.message, request))) {
+                handleNewOrder(session, request);
+            }
+            break;
+        }
+        case OrderEntryMessageType::Cancel: {
+            CancelMessage request;
+            if ((valid = decode(session.message, request))) {
+                handleCancel(session, request);
+            }
+            break;
+        }
+        case OrderEntryMessageType::Amend: {
+            AmendMessage request;
+            if ((valid = decode(session.message, request))) {
+                handleAmend(session, request);
+            }
+            break;
+        }
+        default:
+            // A response type; well framed, so the session carries on
+            break;
+    }
+
+    if (!valid) {
+        bool isRequest = header.type == OrderEntryMessageType::NewOrder || header.type == OrderEntryMessageType::Cancel ||
+                         header.type == OrderEntryMessageType::Amend;
+        std::lock_guard<std::mutex> lock(session.outputMutex);
+        session.append(makeReject(isRequest ? header.type : OrderEntryMessageType::NewOrder, 0, 0,
+                                  RejectReason::InvalidMessage));
+        session.flush();
+    }
+}
+
+void OrderEntryGateway::handleNewOrder(Session& session, const NewOrderMessage& request) {
+    std::unique_lock<std::mutex> outputLock(session.outputMutex);
+
+    // Resolved without interning, so unknown tickers leave no trace
+    SymbolId symbol = request.symbol.empty() ? SymbolId() : handlers.findSymbol(request.symbol);
+    std::optional<RejectReason> reason;
+    if (symbol.empty()) {
+        reason = RejectReason::InvalidSymbol;
+    } else if (request.quantity == 0 || request.quantity > INT_MAX) {
+        reason = RejectReason::InvalidQuantity;
+    } else if (request.type == OrderType::Limit && request.price.ticks <= 0) {
+        reason = RejectReason::InvalidPrice;
+    }
+    if (reason) {
+        session.append(makeReject(OrderEntryMessageType::NewOrder, request.client_order_id, 0, *reason));
+        session.flush();
+        return;
+    }
+
+    Order order(session.id, symbol, request.side, request.type,
+                request.type == OrderType::Limit ? request.price : Price(), static_cast<int>(request.quantity));
+
+    // Registered before matching, so a fill against it as soon as it rests finds its session.
+    // Those fills wait for the output lock we hold, so they always follow this Ack.
+    if (order.is_limit()) {
+        std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+        ownedOrders.emplace(order.id, OwnedOrder{session.weak_from_this(), request.client_order_id, order.symbol, false});
+    }
+
+    std::vector<Trade> trades;
+    bool sweep = false;
+    try {
+        trades = handlers.submitOrder(order);
+        if (order.is_limit()) {
+            std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+            auto it = ownedOrders.find(order.id);
+            if (it != ownedOrders.end()) {
+                it->second.submitted = true;
+            }
+            sweep = ownedOrders.size() >= nextSweepSize;
+        }
+    } catch (const std::exception& e) {
+        log_warn("Order entry session ", session.id, " order rejected: ", e.what());
+        {
+            std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+            ownedOrders.erase(order.id);
+        }
+        session.append(makeReject(OrderEntryMessageType::NewOrder, request.client_order_id, order.id,
+                                  RejectReason::InvalidMessage));
+        session.flush();
+        return;
+    }
+
+    // Market orders never rest, whatever did not match is dropped
+    AckMessage ack;
+    ack.client_order_id = request.client_order_id;
+    ack.order_id = order.id;
+    ack.request = OrderEntryMessageType::NewOrder;
+    ack.executed_quantity = executedQuantity(order.id, trades);
+    ack.leaves_quantity = order.is_limit() ? request.quantity - ack.executed_quantity : 0;
+    session.append(ack);
+    appendOwnFills(session, order.id, request.client_order_id, trades);
+    session.flush();
+
+    // Other sessions are queued under their own locks, never while holding ours
+    outputLock.unlock();
+    if (!trades.empty()) {
+        deliverFills(trades, order.id);
+        if (handlers.onTrades) {
+            handlers.onTrades(trades);
+        }
+    }
+    if (sweep) {
+        sweepOwnedOrders();
+    }
+}
+
+void OrderEntryGateway::handleCancel(Session& session, const CancelMessage& request) {
+    std::optional<SymbolId> symbol;
+    {
+        std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+        auto it = ownedOrders.find(request.order_id);
+        if (it != ownedOrders.end() && it->second.session.lock().get() == &session) {
+            symbol = it->second.symbol;
+        }
+    }
+
+    std::lock_guard<std::mutex> outputLock(session.outputMutex);
+    bool cancelled = false;
+    try {
+        cancelled = symbol && handlers.submitCancel(*symbol, request.order_id);
+    } catch (const std::exception& e) {
+        // Never executed, e.g. while shutting down, so the order is where it was
+        log_warn("Order entry session ", session.id, " cancel failed: ", e.what());
+        session.append(makeReject(OrderEntryMessageType::Cancel, request.client_order_id, request.order_id,
+                                  RejectReason::InvalidMessage));
+        session.flush();
+        return;
+    }
+    if (symbol) {
+        // Out of the book either way
+        std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+        ownedOrders.erase(request.order_id);
+    }
+    if (cancelled) {
+        AckMessage ack;
+        ack.client_order_id = request.client_order_id;
+        ack.order_id = request.order_id;
+        ack.request = OrderEntryMessageType::Cancel;
+        session.append(ack);
+    } else {
+        // Not ours, or filled before the cancel reached the book
+        session.append(makeReject(OrderEntryMessageType::Cancel, request.client_order_id, request.order_id,
+                                  RejectReason::UnknownOrder));
+    }
+    session.flush();
+}
+
+void OrderEntryGateway::handleAmend(Session& session, const AmendMessage& request) {
+    std::optional<OwnedOrder> owned;
+    {
+        std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+        auto it = ownedOrders.find(request.order_id);
+        if (it != ownedOrders.end() && it->second.session.lock().get() == &session) {
+            owned = it->second;
+        }
+    }
+
+    std::unique_lock<std::mutex> outputLock(session.outputMutex);
+    auto rejectAmend = [&](RejectReason reason) {
+        session.append(makeReject(OrderEntryMessageType::Amend, request.client_order_id, request.order_id, reason));
+        session.flush();
+    };
+    auto forget = [&]() {
+        std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+        ownedOrders.erase(request.order_id);
+    };
+    if (!owned) {
+        rejectAmend(RejectReason::UnknownOrder);
+        return;
+    }
+
+    // Read from the book rather than remembered, since REST may have amended it meanwhile.
+    // Fills after this lookup wait for our output lock, so they follow the Ack's leaves.
+    std::optional<Order> current = handlers.findOrder(owned->symbol, request.order_id);
+    if (!current) {
+        forget();
+        rejectAmend(RejectReason::UnknownOrder);
+        return;
+    }
+
+    // Zero keeps the current value, as an omitted field does over REST
+    Price newPrice = request.price.ticks != 0 ? request.price : current->price;
+    if (newPrice.ticks < 0) {
+        rejectAmend(RejectReason::InvalidPrice);
+        return;
+    }
+    if (request.quantity > INT_MAX) {
+        rejectAmend(RejectReason::InvalidQuantity);
+        return;
+    }
+    int newQuantity = request.quantity != 0 ? static_cast<int>(request.quantity) : current->quantity;
+
+    std::optional<std::vector<Trade>> trades;
+    try {
+        trades = handlers.submitAmend(owned->symbol, request.order_id, newPrice, newQuantity);
+    } catch (const std::invalid_argument&) {
+        // At or below the filled quantity
+        rejectAmend(RejectReason::InvalidAmend);
+        return;
+    } catch (const std::exception& e) {
+        log_warn("Order entry session ", session.id, " amend failed: ", e.what());
+        rejectAmend(RejectReason::InvalidMessage);
+        return;
+    }
+    if (!trades) {
+        forget();
+        rejectAmend(RejectReason::UnknownOrder);
+        return;
+    }
+
+    AckMessage ack;
+    ack.client_order_id = request.client_order_id;
+    ack.order_id = request.order_id;
+    ack.request = OrderEntryMessageType::Amend;
+    ack.executed_quantity = executedQuantity(request.order_id, *trades);
+    int leaves = newQuantity - current->filled_quantity() - static_cast<int>(ack.executed_quantity);
+    ack.leaves_quantity = static_cast<uint32_t>(std::max(leaves, 0));
+    session.append(ack);
+    appendOwnFills(session, request.order_id, owned->clientOrderId, *trades);
+    session.flush();
+
+    outputLock.unlock();
+    if (!trades->empty()) {
+        deliverFills(*trades, request.order_id);
+        if (handlers.onTrades) {
+            handlers.onTrades(*trades);
+        }
+    }
+}
+
+void OrderEntryGateway::appendOwnFills(Session& session, uint64_t orderId, uint64_t clientOrderId,
+                                       const std::vector<Trade>& trades) {
+    SymbolId symbol;
+    for (const auto& trade : trades) {
+        if (trade.buy_order_id != orderId && trade.sell_order_id != orderId) {
+            continue;
+        }
+        FillMessage fill;
+        fill.client_order_id = clientOrderId;
+        fill.order_id = orderId;
+        fill.trade_id = trade.trade_id;
+        fill.price = trade.price;
+        fill.quantity = static_cast<uint32_t>(trade.quantity);
+        fill.liquidity = Liquidity::Removed;
+        session.append(fill);
+        symbol = trade.symbol;
+    }
+
+    if (!symbol.empty()) {
+        forgetIfGone(orderId, symbol);
+    }
+}
+
+void OrderEntryGateway::reportTrades(const std::vector<Trade>& trades) {
+    if (!trades.empty()) {
+        deliverFills(trades, 0);
+    }
+}
+
+void OrderEntryGateway::deliverFills(const std::vector<Trade>& trades, uint64_t skipOrderId) {
+    std::vector<std::pair<std::shared_ptr<Session>, FillMessage>> fills;
+    std::vector<std::pair<uint64_t, SymbolId>> traded;
+    {
+        std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+        if (ownedOrders.empty()) {
+            return;
+        }
+        for (const auto& trade : trades) {
+            for (uint64_t orderId : {trade.buy_order_id, trade.sell_order_id}) {
+                auto it = orderId == skipOrderId ? ownedOrders.end() : ownedOrders.find(orderId);
+                if (it == ownedOrders.end()) {
+                    continue;
+                }
+
+                OwnedOrder& owned = it->second;
+                FillMessage fill;
+                fill.client_order_id = owned.clientOrderId;
+                fill.order_id = orderId;
+                fill.trade_id = trade.trade_id;
+                fill.price = trade.price;
+                fill.quantity = static_cast<uint32_t>(trade.quantity);
+                fill.liquidity = Liquidity::Added;
+
+                traded.emplace_back(orderId, owned.symbol);
+                if (std::shared_ptr<Session> session = owned.session.lock()) {
+                    fills.emplace_back(std::move(session), fill);
+                }
+            }
+        }
+    }
+
+    // Queued outside the owners lock, one session lock at a time
+    for (auto& [session, fill] : fills) {
+        std::lock_guard<std::mutex> lock(session->outputMutex);
+        session->append(fill);
+        session->flush();
+    }
+    for (const auto& [orderId, symbol] : traded) {
+        forgetIfGone(orderId, symbol);
+    }
+}
+
+void OrderEntryGateway::forgetIfGone(uint64_t orderId, SymbolId symbol) {
+    // Once an order has left its book it never returns, so a stale answer is safe
+    if (!handlers.findOrder(symbol, orderId)) {
+        std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+        ownedOrders.erase(orderId);
+    }
+}
+
+void OrderEntryGateway::sweepOwnedOrders() {
+    std::vector<std::pair<uint64_t, SymbolId>> candidates;
+    {
+        std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+        candidates.reserve(ownedOrders.size());
+        for (const auto& [orderId, owned] : ownedOrders) {
+            if (owned.submitted) {
+                candidates.emplace_back(orderId, owned.symbol);
+            }
+        }
+    }
+
+    // Looked up outside the owners lock, so fills keep flowing meanwhile
+    std::vector<uint64_t> gone;
+    for (const auto& [orderId, symbol] : candidates) {
+        if (!handlers.findOrder(symbol, orderId)) {
+            gone.push_back(orderId);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+    for (uint64_t orderId : gone) {
+        ownedOrders.erase(orderId);
+    }
+    // Fills for an order whose session has gone have nowhere to go
+    for (auto it = ownedOrders.begin(); it != ownedOrders.end();) {
+        if (it->second.submitted && it->second.session.expired()) {
+            it = ownedOrders.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    nextSweepSize = std::max(MIN_SWEEP_SIZE, ownedOrders.size() * 2);
+}
+
+size_t OrderEntryGateway::getSessionCount() const {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    size_t count = 0;
+    for (const auto& session : sessions) {
+        if (session->open.load()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t OrderEntryGateway::getOwnedOrderCount() const {
+    std::lock_guard<std::mutex> lock(ownedOrdersMutex);
+    return ownedOrders.size();
+}
+
+} // namespace velocore
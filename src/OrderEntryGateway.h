@@ -0,0 +1,149 @@
+#pragma once
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/io_context.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Order.h"
+#include "Trade.h"
+#include "OrderEntryProtocol.h"
+
+namespace velocore {
+
+/**
+ * OrderEntryGateway - Binary order entry over persistent TCP sessions.
+ *
+ * Runs next to the REST API and enters orders through the same calls it
+ * uses, so both share books, the sequencer and statistics. Sessions are
+ * served by a few I/O threads, each session on its own strand so its
+ * requests are handled one at a time. Responses are queued on the session
+ * and written asynchronously, so no thread ever waits on a client's socket;
+ * a request's Ack and immediate fills go out in one write. A session that
+ * lets more than maxQueuedBytes of responses pile up is not reading them
+ * and is disconnected.
+ *
+ * A session may cancel and amend only the orders it entered. The gateway
+ * remembers which session owns each open order, so fills against a resting
+ * order reach its session whichever path entered the other side; trades
+ * made outside the gateway are passed in through reportTrades. An order's
+ * price and quantity are always read from its book, since REST may amend it
+ * too. Owners of orders that left the book some other way, e.g. cancelled
+ * over REST, are forgotten in a sweep whenever the owned orders double.
+ * Orders stay in the book when their session disconnects.
+ */
+class OrderEntryGateway {
+public:
+    struct Handlers {
+        // The symbol a NewOrder's ticker trades as, or the empty SymbolId to reject it
+        std::function<SymbolId(const std::string& symbol)> findSymbol;
+        std::function<std::vector<Trade>(const Order&)> submitOrder;
+        std::function<bool(SymbolId symbol, uint64_t orderId)> submitCancel;
+        std::function<std::optional<std::vector<Trade>>(SymbolId symbol, uint64_t orderId,
+                                                        Price newPrice, int newQuantity)> submitAmend;
+        // The order as it rests in its book now, or std::nullopt once it has left
+        std::function<std::optional<Order>(SymbolId symbol, uint64_t orderId)> findOrder;
+        // Optional, sees every trade the gateway made, e.g. to update statistics
+        std::function<void(const std::vector<Trade>&)> onTrades;
+    };
+
+    // Responses a session may leave unread before it is disconnected
+    static constexpr size_t DEFAULT_MAX_QUEUED_BYTES = 4 * 1024 * 1024;
+
+    explicit OrderEntryGateway(Handlers handlers, size_t maxQueuedBytes = DEFAULT_MAX_QUEUED_BYTES);
+    ~OrderEntryGateway();
+
+    OrderEntryGateway(const OrderEntryGateway&) = delete;
+    OrderEntryGateway& operator=(const OrderEntryGateway&) = delete;
+
+    /**
+     * Starts accepting sessions
+     * @param port TCP port to listen on, 0 for any free port
+     * @param address Local address to listen on; sessions are not authenticated,
+     *        so only bind beyond loopback on a trusted network
+     * @throws boost::system::system_error if the address is invalid or cannot be bound
+     */
+    void start(uint16_t port, const std::string& address = "127.0.0.1");
+
+    /**
+     * Closes the listener and every session and waits for the I/O threads
+     */
+    void stop();
+
+    /**
+     * @return The port being listened on, 0 before start
+     */
+    uint16_t port() const { return boundPort; }
+
+    /**
+     * Sends Added fills for resting gateway orders among these trades
+     * @note Thread-safe - call with trades entered outside the gateway
+     */
+    void reportTrades(const std::vector<Trade>& trades);
+
+    size_t getSessionCount() const;
+
+    // Open orders whose session is remembered, including some awaiting the next sweep
+    size_t getOwnedOrderCount() const;
+
+private:
+    struct Session;
+
+    // An open order entered through the gateway
+    struct OwnedOrder {
+        std::weak_ptr<Session> session;
+        uint64_t clientOrderId;
+        SymbolId symbol;
+        bool submitted;    // Not yet in the book until its submit returns, so sweeps skip it
+    };
+
+    // Owned orders are swept once they reach this many, then again whenever they double
+    static constexpr size_t MIN_SWEEP_SIZE = 1024;
+
+    void acceptNext();
+    void readHeader(const std::shared_ptr<Session>& session);
+    void readBody(const std::shared_ptr<Session>& session, const OrderEntryHeader& header);
+    void handleMessage(Session& session, const OrderEntryHeader& header);
+    void handleNewOrder(Session& session, const NewOrderMessage& request);
+    void handleCancel(Session& session, const CancelMessage& request);
+    void handleAmend(Session& session, const AmendMessage& request);
+
+    // Queues the Removed fills of orderId on its session
+    void appendOwnFills(Session& session, uint64_t orderId, uint64_t clientOrderId,
+                        const std::vector<Trade>& trades);
+
+    // Sends Added fills for every gateway order in trades except skipOrderId
+    void deliverFills(const std::vector<Trade>& trades, uint64_t skipOrderId);
+
+    // Forgets the owner of an order that traded if it has now left the book
+    void forgetIfGone(uint64_t orderId, SymbolId symbol);
+
+    // Forgets the owners of orders no longer in their books or whose session has gone
+    void sweepOwnedOrders();
+
+    Handlers handlers;
+    size_t maxQueuedBytes;
+
+    boost::asio::io_context ioContext;
+    std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor;
+    std::vector<std::thread> ioThreads;
+    std::atomic<bool> running{false};
+    uint16_t boundPort = 0;
+
+    std::vector<std::shared_ptr<Session>> sessions;
+    mutable std::mutex sessionsMutex;
+    uint64_t nextSessionId = 1;
+
+    std::unordered_map<uint64_t, OwnedOrder> ownedOrders;
+    size_t nextSweepSize = MIN_SWEEP_SIZE;
+    mutable std::mutex ownedOrdersMutex;
+};
+
+} // namespace velocore
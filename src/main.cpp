@@ -1,5 +1,4 @@
 #include <crow.h>
-#include <iostream>
 #include <thread>
 #include <ctime>
 #include <vector>
@@ -9,23 +8,47 @@
 #include <chrono>
 #include <unordered_map>
 #include <mutex>
+#include <sstream>
+#include <charconv>
+#include <cstring>
 
 #include "Types.h"
+#include "Price.h"
 #include "Order.h"
 #include "Trade.h"
+#include "ShardedTradeStatistics.h"
 #include "OrderBook.h"
+#include "Exchange.h"
+#include "Sequencer.h"
 #include "Config.h"
 #include "MarketDataFeed.h"
+#include "OrderEntryGateway.h"
+#include "LatencyHistogram.h"
+#include "Logger.h"
+#include "JsonWriter.h"
+#include "SnapshotCache.h"
 
 using namespace velocore;
 
+// Symbol used by routes when the request does not name one
+const std::string DEFAULT_SYMBOL = "SIM";
+
+// Largest batch accepted by POST /orders/batch
+const size_t MAX_BATCH_ORDERS = 1000;
+
 // Global instances
-OrderBook orderBook;
-TradeStatistics stats;
+Exchange exchange;
+std::unique_ptr<Sequencer> sequencer;
+ShardedTradeStatistics stats;
 std::unique_ptr<MarketDataFeed> marketDataFeed;
+std::unique_ptr<OrderEntryGateway> orderEntryGateway;
+
+// Serialized /orderbook and /market responses, rebuilt only once their book changes
+SnapshotCache snapshotCache;
+const uint32_t MARKET_VIEW = 0;    // /orderbook views are their level count, 1 to 20
 
 // Market data storage
-std::unordered_map<std::string, MarketTick> latestTicks;
+std::unordered_map<SymbolId, MarketTick> latestTicks;
 std::mutex ticksMutex;
 
 // Order validation function
@@ -37,7 +60,7 @@ bool validateOrder(const std::string& symbol, Side side, OrderType type, double
         return false;
     }
     
-    if (type == OrderType::Limit && price <= 0) {
+    if (type == OrderType::Limit && (price <= 0 || Price::from_double(price, tick_size_for(symbol)).is_zero())) {
         errorMessage = "Price must be greater than 0 for limit orders";
         return false;
     }
@@ -47,45 +70,163 @@ bool validateOrder(const std::string& symbol, Side side, OrderType type, double
         return false;
     }
     
+    // Checked before the order is parsed, which would intern the ticker
+    if (exchange.findListedSymbol(symbol).empty()) {
+        errorMessage = "Unknown symbol: " + symbol;
+        return false;
+    }
+    
     return true;
 }
 
+// Gets the symbol a request targets, from ?symbol= or the default
+std::string requestSymbol(const crow::request& req) {
+    const char* symbol = req.url_params.get("symbol");
+    return (symbol && *symbol) ? std::string(symbol) : DEFAULT_SYMBOL;
+}
+
+crow::response unknownSymbolResponse(const std::string& symbol) {
+    return crow::response(404, crow::json::wvalue{
+        {"error", "No order book for symbol"},
+        {"symbol", symbol}
+    });
+}
+
+// Reads an unsigned integer query parameter, leaving value untouched if it is absent;
+// false if the parameter is present but not a whole number that fits
+bool unsignedParam(const crow::request& req, const char* name, uint64_t& value) {
+    const char* text = req.url_params.get(name);
+    if (!text) {
+        return true;
+    }
+    const char* end = text + std::strlen(text);
+    std::from_chars_result result = std::from_chars(text, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+crow::response invalidParamResponse(const char* name) {
+    return crow::response(400, crow::json::wvalue{
+        {"error", std::string("Invalid ") + name + ", expected a non-negative integer"}
+    });
+}
+
+// Serializes with a JsonWriter into a per-thread buffer that keeps its capacity between requests
+template<typename Write>
+const std::string& serializeJson(Write&& write) {
+    thread_local std::string buffer;
+    buffer.clear();
+    JsonWriter writer(buffer);
+    write(writer);
+    return buffer;
+}
+
+template<typename Write>
+crow::response streamedJson(int code, Write&& write) {
+    crow::response response(code, serializeJson(std::forward<Write>(write)));
+    response.set_header("Content-Type", "application/json");
+    return response;
+}
+
+// Serves a cached snapshot, or 304 Not Modified if the client already holds it
+crow::response snapshotResponse(const crow::request& req, const CachedSnapshot& snapshot) {
+    crow::response response;
+    if (SnapshotCache::matches(req.get_header_value("If-None-Match"), snapshot.etag)) {
+        response.code = 304;
+    } else {
+        response.code = 200;
+        response.body = snapshot.body;
+        response.set_header("Content-Type", "application/json");
+    }
+    response.set_header("ETag", snapshot.etag);
+    return response;
+}
+
+// Order entry goes through the sequencer's matching thread when it is running
+std::vector<Trade> submitOrder(const Order& order) {
+    if (sequencer) {
+        return sequencer->submitOrder(order).get();
+    }
+    return exchange.addOrder(order);
+}
+
+std::vector<std::vector<Trade>> submitOrders(const std::vector<Order>& orders) {
+    if (sequencer) {
+        return sequencer->submitOrders(orders).get();
+    }
+    return exchange.addOrders(orders);
+}
+
+std::optional<std::vector<Trade>> submitAmend(SymbolId symbol, uint64_t orderId, Price newPrice, int newQuantity) {
+    if (sequencer) {
+        return sequencer->submitAmend(symbol, orderId, newPrice, newQuantity).get();
+    }
+    return exchange.amendOrder(symbol, orderId, newPrice, newQuantity);
+}
+
+bool submitCancel(uint64_t orderId, const char* symbol) {
+    SymbolId symbolId;
+    if (symbol) {
+        // A symbol that was never interned has no book, so nothing to cancel
+        symbolId = find_symbol(symbol);
+        if (symbolId.empty()) {
+            return false;
+        }
+    }
+    
+    if (sequencer) {
+        return sequencer->submitCancel(orderId, symbolId).get();
+    }
+    return symbol ? exchange.cancelOrder(symbolId, orderId) : exchange.cancelOrder(orderId);
+}
+
+// Counts trades made over REST and sends fills to gateway sessions whose resting orders traded
+void recordTrades(const std::vector<Trade>& trades) {
+    for (const auto& trade : trades) {
+        stats.update(trade);
+    }
+    if (orderEntryGateway) {
+        orderEntryGateway->reportTrades(trades);
+    }
+}
+
 // Market data callback functions
 void onMarketTick(const MarketTick& tick) {
     std::lock_guard<std::mutex> lock(ticksMutex);
     latestTicks[tick.symbol] = tick;
     
-    std::cout << "Received " << to_string(tick.type) << " for " << tick.symbol;
     if (tick.type == MarketDataType::Trade) {
-        std::cout << " - Price: $" << tick.trade_price << ", Size: " << tick.trade_size;
+        log_debug("Received ", to_string(tick.type), " for ", tick.symbol,
+                  " - Price: $", tick.trade_price, ", Size: ", tick.trade_size);
     } else if (tick.type == MarketDataType::Quote) {
-        std::cout << " - Bid: $" << tick.bid_price << " x " << tick.bid_size
-                  << ", Ask: $" << tick.ask_price << " x " << tick.ask_size;
+        log_debug("Received ", to_string(tick.type), " for ", tick.symbol,
+                  " - Bid: $", tick.bid_price, " x ", tick.bid_size,
+                  ", Ask: $", tick.ask_price, " x ", tick.ask_size);
+    } else {
+        log_debug("Received ", to_string(tick.type), " for ", tick.symbol);
     }
-    std::cout << std::endl;
 }
 
 void onMarketConnection(bool connected) {
-    std::cout << "Market data connection: " << (connected ? "CONNECTED" : "DISCONNECTED") << std::endl;
+    log_info("Market data connection: ", (connected ? "CONNECTED" : "DISCONNECTED"));
 }
 
 void onMarketError(const std::string& error) {
-    std::cout << "Market data error: " << error << std::endl;
+    log_error("Market data error: ", error);
 }
 
 int main() {
-    std::cout << "=== Velocore Trading Simulator ===" << std::endl;
+    log_info("=== Velocore Trading Simulator ===");
     
     try {
         // Load configuration
-        std::cout << "Loading configuration..." << std::endl;
+        log_info("Loading configuration...");
         Configuration& config = Configuration::getInstance();
         config.loadFromEnvironment();
         config.validateConfiguration();
-        std::cout << "Configuration loaded successfully!" << std::endl;
+        log_info("Configuration loaded successfully!");
         
         // Initialize market data feed
-        std::cout << "Initializing market data feed..." << std::endl;
+        log_info("Initializing market data feed...");
         marketDataFeed = std::make_unique<MarketDataFeed>();
         
         // Register callbacks
@@ -97,24 +238,84 @@ int main() {
         marketDataFeed->start();
         
     } catch (const std::exception& e) {
-        std::cout << "Configuration error: " << e.what() << std::endl;
-        std::cout << "Please set the required environment variables:" << std::endl;
-        std::cout << "  ALPACA_API_KEY=your_api_key" << std::endl;
-        std::cout << "  ALPACA_API_SECRET=your_api_secret" << std::endl;
-        std::cout << "Continuing without market data feed..." << std::endl;
+        log_warn("Configuration error: ", e.what());
+        log_warn("Please set the required environment variables:");
+        log_warn("  ALPACA_API_KEY=your_api_key");
+        log_warn("  ALPACA_API_SECRET=your_api_secret");
+        log_warn("Continuing without market data feed...");
+    }
+    
+    const auto& general_config = Configuration::getInstance().getGeneralConfig();
+    Logger::instance().setLevel(log_level_from_string(general_config.log_level));
+    exchange.configureTradeLogs(general_config.trade_log_capacity, general_config.trade_log_spill_dir);
+    
+    // Only symbols with a book can be traded, so every listed symbol gets one up front.
+    // The default symbol always has a book so its routes work before any order arrives.
+    exchange.getOrCreateBook(intern_symbol(DEFAULT_SYMBOL));
+    std::stringstream listedSymbols(general_config.symbols);
+    std::string listedSymbol;
+    while (std::getline(listedSymbols, listedSymbol, ',')) {
+        listedSymbol.erase(0, listedSymbol.find_first_not_of(" \t"));
+        listedSymbol.erase(listedSymbol.find_last_not_of(" \t") + 1);
+        if (!listedSymbol.empty()) {
+            exchange.getOrCreateBook(intern_symbol(listedSymbol));
+        }
+    }
+    log_info("Trading ", exchange.getSymbols().size(), " symbols");
+    
+    if (general_config.sequencer_mode) {
+        if (general_config.matching_thread_cpu >= 0) {
+            log_info("Starting sequencer matching thread pinned to CPU ", general_config.matching_thread_cpu, "...");
+        } else {
+            log_info("Starting sequencer matching thread...");
+        }
+        sequencer = std::make_unique<Sequencer>(exchange);
+        sequencer->start(general_config.matching_thread_cpu);
+    }
+    
+    if (general_config.order_entry_port > 0) {
+        // Binary sessions enter orders through the same calls as the REST routes
+        OrderEntryGateway::Handlers handlers;
+        handlers.submitOrder = submitOrder;
+        handlers.submitCancel = [](SymbolId symbol, uint64_t orderId) {
+            if (sequencer) {
+                return sequencer->submitCancel(orderId, symbol).get();
+            }
+            return exchange.cancelOrder(symbol, orderId);
+        };
+        handlers.submitAmend = submitAmend;
+        handlers.findSymbol = [](const std::string& symbol) { return exchange.findListedSymbol(symbol); };
+        handlers.findOrder = [](SymbolId symbol, uint64_t orderId) -> std::optional<Order> {
+            OrderBook* book = exchange.findBook(symbol);
+            return book ? book->findOrder(orderId) : std::nullopt;
+        };
+        handlers.onTrades = [](const std::vector<Trade>& trades) {
+            for (const auto& trade : trades) {
+                stats.update(trade);
+            }
+        };
+        
+        orderEntryGateway = std::make_unique<OrderEntryGateway>(std::move(handlers));
+        try {
+            orderEntryGateway->start(static_cast<uint16_t>(general_config.order_entry_port),
+                                     general_config.order_entry_address);
+        } catch (const std::exception& e) {
+            log_error("Order entry gateway failed to start: ", e.what());
+            orderEntryGateway.reset();
+        }
     }
     
-    std::cout << "Initializing Crow web framework..." << std::endl;
+    log_info("Initializing Crow web framework...");
     
     crow::SimpleApp app;
     
     CROW_ROUTE(app, "/ping")([](){
-        std::cout << "Ping endpoint accessed" << std::endl;
+        log_debug("Ping endpoint accessed");
         return crow::json::wvalue{{"message", "pong"}};
     });
     
     CROW_ROUTE(app, "/health")([](){
-        std::cout << "Health check endpoint accessed" << std::endl;
+        log_debug("Health check endpoint accessed");
         return crow::json::wvalue{
             {"status", "healthy"},
             {"service", "velocore"},
@@ -142,9 +343,9 @@ int main() {
     });
     
     CROW_ROUTE(app, "/models/demo")([](){
-        Order sample_buy(1, "SIM", Side::Buy, OrderType::Limit, 100.50, 100);
-        Order sample_sell(2, "SIM", Side::Sell, OrderType::Limit, 101.00, 50);
-        Trade sample_trade(sample_buy.id, sample_sell.id, "SIM", 100.75, 50);
+        Order sample_buy(1, intern_symbol(DEFAULT_SYMBOL), Side::Buy, OrderType::Limit, Price::from_double(100.50), 100);
+        Order sample_sell(2, intern_symbol(DEFAULT_SYMBOL), Side::Sell, OrderType::Limit, Price::from_double(101.00), 50);
+        Trade sample_trade(sample_buy.id, sample_sell.id, intern_symbol(DEFAULT_SYMBOL), Price::from_double(100.75), 50);
         
         return crow::json::wvalue{
             {"message", "Data Models Demonstration"},
@@ -160,13 +361,17 @@ int main() {
     });
     
     CROW_ROUTE(app, "/orders").methods("POST"_method)([](const crow::request& req){
+        ScopedLatency requestLatency(LatencyStage::OrderRequest);
         try {
+            Clock::time_point stageStart = Clock::now();
             auto json_data = crow::json::load(req.body);
+            record_latency(LatencyStage::RequestParse, stageStart);
             if (!json_data) {
                 return crow::response(400, "Invalid JSON");
             }
             
             // Extract order data for validation
+            stageStart = Clock::now();
             std::string symbol = json_data["symbol"].s();
             Side side = side_from_string(json_data["side"].s());
             OrderType type = order_type_from_string(json_data["type"].s());
@@ -175,49 +380,146 @@ int main() {
             
             // VALIDATE THE ORDER
             std::string errorMessage;
-            if (!validateOrder(symbol, side, type, price, quantity, errorMessage)) {
+            bool valid = validateOrder(symbol, side, type, price, quantity, errorMessage);
+            record_latency(LatencyStage::Validation, stageStart);
+            if (!valid) {
                 return crow::response(400, crow::json::wvalue{{"error", errorMessage}});
             }
             
             // Create order from JSON (validation passed)
             Order order = Order::from_json(json_data);
             
-            // Process order through the matching engine
-            std::vector<Trade> executedTrades = orderBook.addOrder(order);
+            // Process order through the matching engine for its symbol
+            // Lock wait and matching are recorded by the book itself
+            std::vector<Trade> executedTrades = submitOrder(order);
             
             // Update statistics with any executed trades
-            for (const auto& trade : executedTrades) {
-                stats.update(trade);
-            }
+            recordTrades(executedTrades);
             
             // Prepare response with order details and immediate executions
-            crow::json::wvalue response;
-            response["order"] = order.to_json();
-            response["immediate_executions"] = static_cast<int>(executedTrades.size());
+            stageStart = Clock::now();
+            crow::response created = streamedJson(201, [&](JsonWriter& writer) {
+                writer.beginObject();
+                writer.key("order");
+                order.write_json(writer);
+                writer.field("immediate_executions", executedTrades.size());
+                
+                if (!executedTrades.empty()) {
+                    writer.key("trades").beginArray();
+                    for (const auto& trade : executedTrades) {
+                        trade.write_json(writer);
+                    }
+                    writer.endArray();
+                }
+                writer.endObject();
+            });
+            record_latency(LatencyStage::Serialization, stageStart);
+            return created;
+        } catch (const std::exception& e) {
+            return crow::response(400, crow::json::wvalue{{"error", e.what()}});
+        }
+    });
+    
+    CROW_ROUTE(app, "/orders/batch").methods("POST"_method)([](const crow::request& req){
+        try {
+            auto json_data = crow::json::load(req.body);
+            if (!json_data || json_data.t() != crow::json::type::List) {
+                return crow::response(400, "Expected a JSON array of orders");
+            }
             
-            if (!executedTrades.empty()) {
-                crow::json::wvalue::list trade_list;
-                for (const auto& trade : executedTrades) {
-                    trade_list.push_back(trade.to_json());
+            std::vector<crow::json::rvalue> items = json_data.lo();
+            if (items.empty() || items.size() > MAX_BATCH_ORDERS) {
+                return crow::response(400, crow::json::wvalue{
+                    {"error", "Batch must contain between 1 and " + std::to_string(MAX_BATCH_ORDERS) + " orders"}
+                });
+            }
+            
+            // Validate every order up front; rejected ones are reported but don't sink the batch
+            std::vector<Order> orders;
+            std::vector<size_t> accepted;
+            std::vector<std::string> errors(items.size());
+            for (size_t i = 0; i < items.size(); ++i) {
+                try {
+                    const auto& item = items[i];
+                    std::string symbol = item["symbol"].s();
+                    Side side = side_from_string(item["side"].s());
+                    OrderType type = order_type_from_string(item["type"].s());
+                    double price = item["price"].d();
+                    int quantity = item["quantity"].i();
+                    
+                    if (validateOrder(symbol, side, type, price, quantity, errors[i])) {
+                        orders.push_back(Order::from_json(item));
+                        accepted.push_back(i);
+                    }
+                } catch (const std::exception& e) {
+                    errors[i] = e.what();
                 }
-                response["trades"] = std::move(trade_list);
             }
             
-            return crow::response(201, response);
+            // One matching pass for every accepted order
+            std::vector<std::vector<Trade>> executedTrades = submitOrders(orders);
+            
+            size_t total_executions = 0;
+            for (size_t n = 0; n < accepted.size(); ++n) {
+                recordTrades(executedTrades[n]);
+                total_executions += executedTrades[n].size();
+            }
+            
+            return streamedJson(200, [&](JsonWriter& writer) {
+                writer.beginObject()
+                    .field("accepted", accepted.size())
+                    .field("rejected", items.size() - accepted.size())
+                    .field("immediate_executions", total_executions)
+                    .key("results").beginArray();
+                // accepted is in index order, so one cursor walks it alongside the items
+                size_t n = 0;
+                for (size_t i = 0; i < items.size(); ++i) {
+                    writer.beginObject().field("index", i);
+                    if (n < accepted.size() && accepted[n] == i) {
+                        writer.field("status", "accepted").key("order");
+                        orders[n].write_json(writer);
+                        writer.field("immediate_executions", executedTrades[n].size())
+                            .key("trades").beginArray();
+                        for (const auto& trade : executedTrades[n]) {
+                            trade.write_json(writer);
+                        }
+                        writer.endArray();
+                        ++n;
+                    } else {
+                        writer.field("status", "rejected").field("error", errors[i]);
+                    }
+                    writer.endObject();
+                }
+                writer.endArray().endObject();
+            });
         } catch (const std::exception& e) {
             return crow::response(400, crow::json::wvalue{{"error", e.what()}});
         }
     });
     
     CROW_ROUTE(app, "/orders")([](){
+        crow::json::wvalue book_statistics;
+        for (SymbolId symbol : exchange.getSymbols()) {
+            if (OrderBook* book = exchange.findBook(symbol)) {
+                book_statistics[symbol_name(symbol)] = book->getBookStatistics();
+            }
+        }
+        
         return crow::json::wvalue{
-            {"message", "Use /orderbook for current order book state"},
-            {"active_orders", static_cast<int>(orderBook.getTotalOrders())},
-            {"book_statistics", orderBook.getBookStatistics()}
+            {"message", "Use /orderbook?symbol=<sym> for current order book state"},
+            {"active_orders", static_cast<int>(exchange.getTotalOrders())},
+            {"book_statistics", std::move(book_statistics)}
         };
     });
     
     CROW_ROUTE(app, "/orderbook")([](const crow::request& req){
+        std::string symbol = requestSymbol(req);
+        SymbolId symbolId = find_symbol(symbol);
+        OrderBook* book = exchange.findBook(symbolId);
+        if (!book) {
+            return unknownSymbolResponse(symbol);
+        }
+        
         // Get number of levels to display (default: 5)
         int levels = 5;
         if (req.url_params.get("levels")) {
@@ -225,10 +527,21 @@ int main() {
             levels = std::max(1, std::min(levels, 20)); // Limit between 1 and 20
         }
         
-        return crow::json::wvalue{
-            {"orderbook", orderBook.getBookSnapshot(levels)},
-            {"statistics", orderBook.getBookStatistics()}
-        };
+        // Read the version before serializing, see SnapshotCache
+        SnapshotKey key{symbolId, static_cast<uint32_t>(levels)};
+        SnapshotVersion version{book->getVersion(), 0};
+        std::shared_ptr<const CachedSnapshot> snapshot = snapshotCache.find(key, version);
+        if (!snapshot) {
+            snapshot = snapshotCache.store(key, version, serializeJson([&](JsonWriter& writer) {
+                writer.beginObject()
+                    .field("symbol", symbol)
+                    .key("orderbook");
+                book->writeBookSnapshot(writer, levels);
+                writer.key("statistics").raw(book->getBookStatistics().dump())
+                    .endObject();
+            }));
+        }
+        return snapshotResponse(req, *snapshot);
     });
     
     CROW_ROUTE(app, "/trades").methods("POST"_method)([](const crow::request& req){
@@ -239,44 +552,168 @@ int main() {
         });
     });
     
-    CROW_ROUTE(app, "/trades")([](){
-        crow::json::wvalue::list trade_list;
-        auto trades = orderBook.getTradeLog();
-        for (const auto& trade : trades) {
-            trade_list.push_back(trade.to_json());
+    CROW_ROUTE(app, "/trades")([](const crow::request& req){
+        // Cursor pagination: clients pass back next_since_id to tail new executions
+        uint64_t since_id = 0;
+        if (!unsignedParam(req, "since_id", since_id)) {
+            return invalidParamResponse("since_id");
         }
         
-        return crow::json::wvalue{
-            {"trades", std::move(trade_list)},
-            {"total_trades", static_cast<int>(trades.size())},
-            {"statistics", stats.to_json()}
-        };
+        uint64_t limit = 100;
+        if (!unsignedParam(req, "limit", limit)) {
+            return invalidParamResponse("limit");
+        }
+        limit = std::max<uint64_t>(1, std::min<uint64_t>(limit, 1000)); // Limit between 1 and 1000
+        
+        std::vector<Trade> trades;
+        size_t total_trades = 0;
+        if (const char* symbol = req.url_params.get("symbol")) {
+            OrderBook* book = exchange.findBook(find_symbol(symbol));
+            if (!book) {
+                return unknownSymbolResponse(symbol);
+            }
+            trades = book->getTradesSince(since_id, limit);
+            total_trades = book->getTradeCount();
+        } else {
+            trades = exchange.getTradesSince(since_id, limit);
+            total_trades = exchange.getTradeCount();
+        }
+        
+        uint64_t next_since_id = trades.empty() ? since_id : trades.back().trade_id;
+        return streamedJson(200, [&](JsonWriter& writer) {
+            writer.beginObject().key("trades").beginArray();
+            for (const auto& trade : trades) {
+                trade.write_json(writer);
+            }
+            writer.endArray()
+                .field("count", trades.size())
+                .field("next_since_id", next_since_id)
+                .field("total_trades", total_trades)
+                .key("statistics");
+            stats.snapshot().write_json(writer);
+            writer.endObject();
+        });
     });
     
-    CROW_ROUTE(app, "/trades/<int>")([]( int trade_id){
-        auto trades = orderBook.getTradeLog();
-        for (const auto& trade : trades) {
-            if (trade.trade_id == static_cast<uint64_t>(trade_id)) {
-                return crow::response(200, trade.to_json());
+    CROW_ROUTE(app, "/trades/<uint>")([](const crow::request& req, uint64_t trade_id){
+        std::optional<Trade> trade;
+        if (const char* symbol = req.url_params.get("symbol")) {
+            if (OrderBook* book = exchange.findBook(find_symbol(symbol))) {
+                trade = book->findTrade(trade_id);
             }
+        } else {
+            trade = exchange.findTrade(trade_id);
+        }
+        
+        if (trade) {
+            return crow::response(200, trade->to_json());
         }
         return crow::response(404, crow::json::wvalue{{"error", "Trade not found"}});
     });
     
-    CROW_ROUTE(app, "/statistics")([](){
-        return crow::json::wvalue{
-            {"orderbook", orderBook.getBookStatistics()},
+    CROW_ROUTE(app, "/statistics")([](const crow::request& req){
+        std::string symbol = requestSymbol(req);
+        OrderBook* book = exchange.findBook(find_symbol(symbol));
+        if (!book) {
+            return unknownSymbolResponse(symbol);
+        }
+        
+        TopOfBook top = book->getTopOfBook();
+        double tickSize = book->getTickSize();
+        
+        return crow::response(200, crow::json::wvalue{
+            {"symbol", symbol},
+            {"orderbook", book->getBookStatistics()},
             {"market_data", crow::json::wvalue{
-                {"best_bid", orderBook.getBestBid()},
-                {"best_ask", orderBook.getBestAsk()},
-                {"spread", orderBook.getSpread()}
+                {"best_bid", top.bid_price.to_double(tickSize)},
+                {"best_ask", top.ask_price.to_double(tickSize)},
+                {"spread", top.spread().to_double(tickSize)}
             }},
             {"trades", stats.to_json()}
-        };
+        });
+    });
+    
+    CROW_ROUTE(app, "/metrics")([](){
+        // Prometheus text exposition format
+        crow::response response(200, latency_metrics_prometheus());
+        response.set_header("Content-Type", "text/plain; version=0.0.4");
+        return response;
     });
     
-    CROW_ROUTE(app, "/orders/<int>/cancel").methods("POST"_method)([](int order_id){
-        bool cancelled = orderBook.cancelOrder(static_cast<uint64_t>(order_id));
+    CROW_ROUTE(app, "/analytics")([](const crow::request& req){
+        std::string symbol = requestSymbol(req);
+        OrderBook* book = exchange.findBook(find_symbol(symbol));
+        if (!book) {
+            return unknownSymbolResponse(symbol);
+        }
+        
+        return crow::response(200, crow::json::wvalue{
+            {"symbol", symbol},
+            {"windows", book->getAnalytics()}
+        });
+    });
+    
+    CROW_ROUTE(app, "/orders/<uint>/amend").methods("POST"_method)([](const crow::request& req, uint64_t order_id){
+        try {
+            auto json_data = crow::json::load(req.body);
+            if (!json_data) {
+                return crow::response(400, "Invalid JSON");
+            }
+            
+            // Find the resting order so omitted fields keep their current values
+            std::optional<Order> current;
+            if (const char* symbol = req.url_params.get("symbol")) {
+                if (OrderBook* book = exchange.findBook(find_symbol(symbol))) {
+                    current = book->findOrder(order_id);
+                }
+            } else {
+                current = exchange.findOrder(order_id);
+            }
+            if (!current) {
+                return crow::response(404, crow::json::wvalue{
+                    {"error", "Order not found or already executed"},
+                    {"order_id", order_id}
+                });
+            }
+            
+            Price new_price = json_data.has("price")
+                ? Price::from_double(json_data["price"].d(), tick_size_for(current->symbol))
+                : current->price;
+            int new_quantity = json_data.has("quantity")
+                ? static_cast<int>(json_data["quantity"].i())
+                : current->quantity;
+            
+            auto trades = submitAmend(current->symbol, order_id, new_price, new_quantity);
+            if (!trades) {
+                // Filled or cancelled between the lookup and the amend
+                return crow::response(404, crow::json::wvalue{
+                    {"error", "Order not found or already executed"},
+                    {"order_id", order_id}
+                });
+            }
+            
+            recordTrades(*trades);
+            return streamedJson(200, [&](JsonWriter& writer) {
+                writer.beginObject()
+                    .field("message", "Order amended successfully")
+                    .field("order_id", order_id)
+                    .field("price", new_price.to_double(tick_size_for(current->symbol)))
+                    .field("quantity", new_quantity)
+                    .field("immediate_executions", trades->size())
+                    .key("trades").beginArray();
+                for (const auto& trade : *trades) {
+                    trade.write_json(writer);
+                }
+                writer.endArray().endObject();
+            });
+        } catch (const std::exception& e) {
+            return crow::response(400, crow::json::wvalue{{"error", e.what()}});
+        }
+    });
+    
+    CROW_ROUTE(app, "/orders/<uint>/cancel").methods("POST"_method)([](const crow::request& req, uint64_t order_id){
+        // Route straight to the symbol's book when the client names it
+        bool cancelled = submitCancel(order_id, req.url_params.get("symbol"));
         
         if (cancelled) {
             return crow::response(200, crow::json::wvalue{
@@ -291,16 +728,42 @@ int main() {
         }
     });
     
-    CROW_ROUTE(app, "/market")([](){
-        return crow::json::wvalue{
-            {"symbol", "SIM"},
-            {"best_bid", orderBook.getBestBid()},
-            {"best_ask", orderBook.getBestAsk()},
-            {"spread", orderBook.getSpread()},
-            {"total_active_orders", static_cast<int>(orderBook.getTotalOrders())},
-            {"total_trades", static_cast<int>(orderBook.getTradeCount())},
-            {"last_trade_stats", stats.to_json()}
-        };
+    CROW_ROUTE(app, "/market")([](const crow::request& req){
+        std::string symbol = requestSymbol(req);
+        SymbolId symbolId = find_symbol(symbol);
+        OrderBook* book = exchange.findBook(symbolId);
+        if (!book) {
+            return unknownSymbolResponse(symbol);
+        }
+        
+        // The exchange-wide statistics change without this book changing, so they version the response too
+        SnapshotKey key{symbolId, MARKET_VIEW};
+        SnapshotVersion version{book->getVersion(), stats.tradeCount()};
+        std::shared_ptr<const CachedSnapshot> snapshot = snapshotCache.find(key, version);
+        if (!snapshot) {
+            // One consistent top-of-book read, without taking the book lock
+            TopOfBook top = book->getTopOfBook();
+            double tickSize = book->getTickSize();
+            
+            snapshot = snapshotCache.store(key, version, serializeJson([&](JsonWriter& writer) {
+                writer.beginObject()
+                    .field("symbol", symbol)
+                    .field("best_bid", top.bid_price.to_double(tickSize))
+                    .field("best_bid_size", top.bid_quantity)
+                    .field("best_ask", top.ask_price.to_double(tickSize))
+                    .field("best_ask_size", top.ask_quantity)
+                    .field("spread", top.spread().to_double(tickSize))
+                    .field("last_trade_price", top.last_trade_price.to_double(tickSize))
+                    .field("last_trade_quantity", top.last_trade_quantity)
+                    .field("sequence", top.sequence)
+                    .field("total_active_orders", book->getTotalOrders())
+                    .field("total_trades", book->getTradeCount())
+                    .key("last_trade_stats");
+                stats.snapshot().write_json(writer);
+                writer.endObject();
+            }));
+        }
+        return snapshotResponse(req, *snapshot);
     });
     
     // Concurrency testing endpoint - creates multiple simultaneous orders
@@ -318,6 +781,9 @@ int main() {
                 return crow::response(400, "num_orders must be between 1 and 1000");
             }
             
+            SymbolId symbol = intern_symbol(DEFAULT_SYMBOL);
+            OrderBook& book = exchange.getOrCreateBook(symbol);
+            
             std::vector<std::thread> threads;
             std::atomic<int> completed_orders{0};
             std::atomic<int> total_trades{0};
@@ -331,22 +797,20 @@ int main() {
                         try {
                             // Create alternating buy/sell orders
                             Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
-                            double price = (side == Side::Buy) ? 99.0 + (i % 10) : 101.0 + (i % 10);
+                            Price price = Price::from_double((side == Side::Buy) ? 99.0 + (i % 10) : 101.0 + (i % 10));
                             int quantity = 10 + (i % 40);
                             
-                            Order order(i + 1000, "SIM", side, OrderType::Limit, price, quantity);
+                            Order order(i + 1000, symbol, side, OrderType::Limit, price, quantity);
                             
                             // Submit order to matching engine
-                            std::vector<Trade> trades = orderBook.addOrder(order);
+                            std::vector<Trade> trades = submitOrder(order);
                             
                             // Update counters
                             completed_orders.fetch_add(1);
                             total_trades.fetch_add(trades.size());
                             
                             // Update statistics
-                            for (const auto& trade : trades) {
-                                stats.update(trade);
-                            }
+                            recordTrades(trades);
                             
                         } catch (const std::exception& e) {
                             // Continue on error
@@ -370,7 +834,7 @@ int main() {
                 {"duration_ms", static_cast<int>(duration.count())},
                 {"threads_used", num_threads},
                 {"orders_per_second", completed_orders.load() * 1000.0 / duration.count()},
-                {"final_book_state", orderBook.getBookSnapshot(3)},
+                {"final_book_state", book.getBookSnapshot(3)},
                 {"final_statistics", stats.to_json()}
             });
             
@@ -414,8 +878,8 @@ int main() {
             bool bars = json_data.has("bars") ? json_data["bars"].b() : false;
             
             // Add debugging information
-            std::cout << "Subscription request for symbol: " << symbol << std::endl;
-            std::cout << "MarketDataFeed connected: " << (marketDataFeed->isConnected() ? "true" : "false") << std::endl;
+            log_debug("Subscription request for symbol: ", symbol);
+            log_debug("MarketDataFeed connected: ", (marketDataFeed->isConnected() ? "true" : "false"));
             
             // Check if symbol is valid
             if (symbol.empty()) {
@@ -425,15 +889,15 @@ int main() {
             // Attempt subscription
             try {
                 marketDataFeed->subscribe(symbol, trades, quotes, bars);
-                std::cout << "Successfully queued subscription for " << symbol << std::endl;
+                log_info("Successfully queued subscription for ", symbol);
                 return crow::response{200, "Subscribed to " + symbol};
             } catch (const std::exception& e) {
-                std::cout << "Exception during subscription: " << e.what() << std::endl;
+                log_error("Exception during subscription: ", e.what());
                 return crow::response{500, "Internal error during subscription: " + std::string(e.what())};
             }
             
         } catch (const std::exception& e) {
-            std::cout << "Exception in subscription endpoint: " << e.what() << std::endl;
+            log_error("Exception in subscription endpoint: ", e.what());
             return crow::response{400, "Error: " + std::string(e.what())};
         }
     });
@@ -441,59 +905,69 @@ int main() {
     CROW_ROUTE(app, "/market/data/<string>")([]( const std::string& symbol){
         std::lock_guard<std::mutex> lock(ticksMutex);
         
-        auto it = latestTicks.find(symbol);
+        auto it = latestTicks.find(find_symbol(symbol));
         if (it == latestTicks.end()) {
             return crow::response{404, "No data available for symbol: " + symbol};
         }
         
-        return crow::response{200, it->second.to_json().dump()};
+        return streamedJson(200, [&](JsonWriter& writer) {
+            it->second.write_json(writer);
+        });
     });
     
     CROW_ROUTE(app, "/market/data")([](){
         std::lock_guard<std::mutex> lock(ticksMutex);
         
-        crow::json::wvalue response;
-        response["symbols"] = crow::json::wvalue::list();
-        
-        auto symbols_list = crow::json::wvalue::list();
-        for (const auto& [symbol, tick] : latestTicks) {
-            symbols_list.push_back(tick.to_json());
-        }
-        
-        response["ticks"] = std::move(symbols_list);
-        response["count"] = latestTicks.size();
-        
-        return response;
+        return streamedJson(200, [&](JsonWriter& writer) {
+            writer.beginObject()
+                .key("symbols").beginArray().endArray()
+                .key("ticks").beginArray();
+            for (const auto& [symbol, tick] : latestTicks) {
+                tick.write_json(writer);
+            }
+            writer.endArray()
+                .field("count", latestTicks.size())
+                .endObject();
+        });
     });
     
     const int port = 18080;
-    std::cout << "Starting server on port " << port << std::endl;
-    std::cout << "Available endpoints:" << std::endl;
-    std::cout << "  GET  /ping               - Simple ping/pong test" << std::endl;
-    std::cout << "  GET  /health             - Detailed health check" << std::endl;
-    std::cout << "  GET  /architecture       - System architecture overview" << std::endl;
-    std::cout << "  GET  /models/demo        - Data models demonstration" << std::endl;
-    std::cout << "  POST /orders             - Submit new order (triggers matching engine)" << std::endl;
-    std::cout << "  GET  /orders             - Order book summary" << std::endl;
-    std::cout << "  GET  /orderbook          - Current order book snapshot (levels=N)" << std::endl;
-    std::cout << "  POST /orders/<id>/cancel - Cancel an active order" << std::endl;
-    std::cout << "  GET  /trades             - List all executed trades" << std::endl;
-    std::cout << "  GET  /trades/<id>        - Get specific trade" << std::endl;
-    std::cout << "  GET  /market             - Current market data summary" << std::endl;
-    std::cout << "  GET  /statistics         - Market statistics and order book metrics" << std::endl;
-    std::cout << "  POST /test/concurrency   - Test concurrent order submission (for testing thread safety)" << std::endl;
-    std::cout << "  GET  /market/status      - Market data connection status" << std::endl;
-    std::cout << "  POST /market/subscribe   - Subscribe to market data for symbol" << std::endl;
-    std::cout << "  GET  /market/data        - Get all cached market data" << std::endl;
-    std::cout << "  GET  /market/data/<sym>  - Get latest market data for specific symbol" << std::endl;
-    std::cout << std::endl;
-    std::cout << "Server running with multithreading enabled..." << std::endl;
-    std::cout << "Hardware concurrency: " << std::thread::hardware_concurrency() << " threads" << std::endl;
+    log_info("Starting server on port ", port);
+    log_info("Available endpoints:");
+    log_info("  GET  /ping               - Simple ping/pong test");
+    log_info("  GET  /health             - Detailed health check");
+    log_info("  GET  /architecture       - System architecture overview");
+    log_info("  GET  /models/demo        - Data models demonstration");
+    log_info("  POST /orders             - Submit new order (triggers matching engine)");
+    log_info("  POST /orders/batch       - Submit a JSON array of orders, matched under one lock");
+    log_info("  GET  /orders             - Order book summary");
+    log_info("  GET  /orderbook          - Current order book snapshot (symbol=S, levels=N)");
+    log_info("  POST /orders/<id>/amend  - Change an active order's price/quantity (symbol=S optional)");
+    log_info("  POST /orders/<id>/cancel - Cancel an active order (symbol=S optional)");
+    log_info("  GET  /trades             - List recent trades (symbol=S, since_id=N, limit=N optional)");
+    log_info("  GET  /trades/<id>        - Get specific trade (symbol=S optional)");
+    log_info("  GET  /market             - Current market data summary (symbol=S)");
+    log_info("  GET  /statistics         - Market statistics and order book metrics (symbol=S)");
+    log_info("  POST /test/concurrency   - Test concurrent order submission (for testing thread safety)");
+    log_info("  GET  /market/status      - Market data connection status");
+    log_info("  POST /market/subscribe   - Subscribe to market data for symbol");
+    log_info("  GET  /market/data        - Get all cached market data");
+    log_info("  GET  /market/data/<sym>  - Get latest market data for specific symbol");
+    log_info("Server running with multithreading enabled...");
+    log_info("Hardware concurrency: ", std::thread::hardware_concurrency(), " threads");
     
     app.port(port).multithreaded().run();
     
     // Cleanup
-    std::cout << "Shutting down..." << std::endl;
+    log_info("Shutting down...");
+    if (orderEntryGateway) {
+        orderEntryGateway->stop();
+        orderEntryGateway.reset();
+    }
+    if (sequencer) {
+        sequencer->stop();
+        sequencer.reset();
+    }
     if (marketDataFeed) {
         marketDataFeed->stop();
         marketDataFeed.reset();
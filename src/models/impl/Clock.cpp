@@ -0,0 +1,107 @@
+#include "Clock.h"
+#include <fstream>
+#include <string>
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <x86intrin.h>
+#define VELOCORE_HAS_TSC 1
+#endif
+
+namespace velocore {
+
+namespace {
+
+// Longer windows give a more accurate tick rate; 10ms is within a few parts per million
+constexpr auto CALIBRATION_WINDOW = std::chrono::milliseconds(10);
+
+struct Calibration {
+    bool useTsc = false;
+    uint64_t tscBase = 0;
+    double nanosPerTick = 0.0;
+    std::chrono::steady_clock::time_point tscSteadyBase;
+
+    // Read back to back, for converting to wall time
+    std::chrono::steady_clock::time_point steadyBase;
+    std::chrono::system_clock::time_point systemBase;
+};
+
+#ifdef VELOCORE_HAS_TSC
+// The kernel only keeps the TSC as its clock source if it is invariant and in sync across cores
+bool kernelTrustsTsc() {
+    std::ifstream source("/sys/devices/system/clocksource/clocksource0/current_clocksource");
+    std::string name;
+    return (source >> name) && name == "tsc";
+}
+#endif
+
+Calibration calibrate() {
+    Calibration calibration;
+    calibration.steadyBase = std::chrono::steady_clock::now();
+    calibration.systemBase = std::chrono::system_clock::now();
+
+#ifdef VELOCORE_HAS_TSC
+    if (kernelTrustsTsc()) {
+        uint64_t tscStart = __rdtsc();
+        auto steadyStart = std::chrono::steady_clock::now();
+        auto steadyEnd = steadyStart;
+        while (steadyEnd - steadyStart < CALIBRATION_WINDOW) {
+            steadyEnd = std::chrono::steady_clock::now();
+        }
+        uint64_t tscEnd = __rdtsc();
+
+        if (tscEnd > tscStart) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(steadyEnd - steadyStart);
+            calibration.useTsc = true;
+            calibration.tscBase = tscStart;
+            calibration.nanosPerTick = static_cast<double>(elapsed.count()) / static_cast<double>(tscEnd - tscStart);
+            calibration.tscSteadyBase = steadyStart;
+        }
+    }
+#endif
+
+    return calibration;
+}
+
+const Calibration& calibration() {
+    static const Calibration instance = calibrate();
+    return instance;
+}
+
+} // namespace
+
+Clock::time_point Clock::now() {
+#ifdef VELOCORE_HAS_TSC
+    const Calibration& current = calibration();
+    if (current.useTsc) {
+        double nanos = static_cast<double>(__rdtsc() - current.tscBase) * current.nanosPerTick;
+        return current.tscSteadyBase + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(static_cast<int64_t>(nanos)));
+    }
+#endif
+    return std::chrono::steady_clock::now();
+}
+
+std::chrono::system_clock::time_point Clock::toSystem(time_point time) {
+    const Calibration& current = calibration();
+    return current.systemBase + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        time - current.steadyBase);
+}
+
+Clock::time_point Clock::fromSystem(std::chrono::system_clock::time_point time) {
+    const Calibration& current = calibration();
+    return current.steadyBase + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        time - current.systemBase);
+}
+
+int64_t Clock::toUnixMillis(time_point time) {
+    if (time == time_point{}) {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(toSystem(time).time_since_epoch()).count();
+}
+
+bool Clock::usesTsc() {
+    return calibration().useTsc;
+}
+
+} // namespace velocore
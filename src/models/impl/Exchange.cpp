@@ -0,0 +1,191 @@
+#include "Exchange.h"
+#include <algorithm>
+#include <mutex>
+
+namespace velocore {
+
+void Exchange::configureTradeLogs(size_t capacity, const std::string& spillDirectory) {
+    std::unique_lock<std::shared_mutex> lock(booksMutex);
+    tradeLogCapacity = capacity;
+    tradeSpillDirectory = spillDirectory;
+}
+
+OrderBook& Exchange::getOrCreateBook(SymbolId symbol) {
+    {
+        // Fast path - the symbol already has a book
+        std::shared_lock<std::shared_mutex> lock(booksMutex);
+        auto it = books.find(symbol);
+        if (it != books.end()) {
+            return *it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(booksMutex);
+    auto& book = books[symbol];
+    if (!book) {
+        std::string spillPath = tradeSpillDirectory.empty() ? "" : tradeSpillDirectory + "/" + symbol_name(symbol) + ".trades";
+        book = std::make_unique<OrderBook>(tick_size_for(symbol), tradeLogCapacity, spillPath, symbol);
+    }
+    return *book;
+}
+
+OrderBook* Exchange::findBook(SymbolId symbol) const {
+    std::shared_lock<std::shared_mutex> lock(booksMutex);
+    auto it = books.find(symbol);
+    return it == books.end() ? nullptr : it->second.get();
+}
+
+SymbolId Exchange::findListedSymbol(const std::string& symbol) const {
+    SymbolId id = find_symbol(symbol);
+    return !id.empty() && findBook(id) ? id : SymbolId();
+}
+
+std::vector<Trade> Exchange::addOrder(const Order& order) {
+    return getOrCreateBook(order.symbol).addOrder(order);
+}
+
+std::vector<std::vector<Trade>> Exchange::addOrders(const std::vector<Order>& orders) {
+    // Group positions by symbol, keeping arrival order within each symbol
+    std::vector<SymbolId> symbols;
+    std::unordered_map<SymbolId, std::vector<size_t>> positionsBySymbol;
+    for (size_t i = 0; i < orders.size(); ++i) {
+        auto& positions = positionsBySymbol[orders[i].symbol];
+        if (positions.empty()) {
+            symbols.push_back(orders[i].symbol);
+        }
+        positions.push_back(i);
+    }
+    
+    std::vector<std::vector<Trade>> results(orders.size());
+    for (SymbolId symbol : symbols) {
+        const auto& positions = positionsBySymbol[symbol];
+        std::vector<Order> symbolOrders;
+        symbolOrders.reserve(positions.size());
+        for (size_t position : positions) {
+            symbolOrders.push_back(orders[position]);
+        }
+        
+        std::vector<std::vector<Trade>> symbolResults = getOrCreateBook(symbol).addOrders(symbolOrders);
+        for (size_t i = 0; i < positions.size(); ++i) {
+            results[positions[i]] = std::move(symbolResults[i]);
+        }
+    }
+    return results;
+}
+
+bool Exchange::cancelOrder(SymbolId symbol, uint64_t orderId) {
+    OrderBook* book = findBook(symbol);
+    return book && book->cancelOrder(orderId);
+}
+
+bool Exchange::cancelOrder(uint64_t orderId) {
+    std::shared_lock<std::shared_mutex> lock(booksMutex);
+    for (auto& [symbol, book] : books) {
+        if (book->cancelOrder(orderId)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::optional<std::vector<Trade>> Exchange::amendOrder(SymbolId symbol, uint64_t orderId,
+                                                       Price newPrice, int newQuantity) {
+    OrderBook* book = findBook(symbol);
+    if (!book) {
+        return std::nullopt;
+    }
+    return book->amendOrder(orderId, newPrice, newQuantity);
+}
+
+std::optional<Order> Exchange::findOrder(uint64_t orderId) const {
+    std::shared_lock<std::shared_mutex> lock(booksMutex);
+    for (const auto& [symbol, book] : books) {
+        if (auto order = book->findOrder(orderId)) {
+            return order;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<SymbolId> Exchange::getSymbols() const {
+    std::shared_lock<std::shared_mutex> lock(booksMutex);
+    std::vector<SymbolId> symbols;
+    symbols.reserve(books.size());
+    for (const auto& [symbol, book] : books) {
+        symbols.push_back(symbol);
+    }
+    return symbols;
+}
+
+std::vector<Trade> Exchange::getTradeLog() const {
+    std::shared_lock<std::shared_mutex> lock(booksMutex);
+    std::vector<Trade> trades;
+    for (const auto& [symbol, book] : books) {
+        std::vector<Trade> bookTrades = book->getTradeLog();
+        trades.insert(trades.end(), bookTrades.begin(), bookTrades.end());
+    }
+
+    std::sort(trades.begin(), trades.end());
+    return trades;
+}
+
+std::optional<Trade> Exchange::findTrade(uint64_t tradeId) const {
+    // The id names the book that made the trade
+    OrderBook* book = findBook(trade_symbol(tradeId));
+    return book ? book->findTrade(tradeId) : std::nullopt;
+}
+
+std::vector<Trade> Exchange::getTradesSince(uint64_t sinceId, size_t limit) const {
+    // Trade ids only order trades within a book, so the cursor's place in the
+    // merged stream is its time
+    std::optional<Trade> cursor;
+    if (sinceId != 0) {
+        cursor = findTrade(sinceId);
+    }
+    
+    std::shared_lock<std::shared_mutex> lock(booksMutex);
+    
+    // Books are read one after another, so a book read early can still gain trades
+    // stamped before ones read from a later book. Trades are stamped under their
+    // book's lock, so every trade stamped before this cutoff is already visible
+    // once we hold that lock; anything newer waits for the next page.
+    Clock::time_point cutoff = Clock::now();
+    
+    // The first page across all books is contained in the first page of each book
+    std::vector<Trade> trades;
+    for (const auto& [symbol, book] : books) {
+        std::vector<Trade> bookTrades = cursor ? book->getTradesAfter(*cursor, limit) : book->getTradesSince(0, limit);
+        for (const Trade& trade : bookTrades) {
+            if (trade.timestamp >= cutoff) {
+                break;
+            }
+            trades.push_back(trade);
+        }
+    }
+    
+    std::sort(trades.begin(), trades.end());
+    if (trades.size() > limit) {
+        trades.resize(limit);
+    }
+    return trades;
+}
+
+size_t Exchange::getTotalOrders() const {
+    std::shared_lock<std::shared_mutex> lock(booksMutex);
+    size_t total = 0;
+    for (const auto& [symbol, book] : books) {
+        total += book->getTotalOrders();
+    }
+    return total;
+}
+
+size_t Exchange::getTradeCount() const {
+    std::shared_lock<std::shared_mutex> lock(booksMutex);
+    size_t total = 0;
+    for (const auto& [symbol, book] : books) {
+        total += book->getTradeCount();
+    }
+    return total;
+}
+
+} // namespace velocore
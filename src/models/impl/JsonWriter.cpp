@@ -0,0 +1,147 @@
+#include "JsonWriter.h"
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+
+namespace velocore {
+
+void JsonWriter::separate() {
+    if (afterKey) {
+        // The value of a key follows its colon directly
+        afterKey = false;
+        return;
+    }
+    if (depth > 0) {
+        uint64_t bit = uint64_t(1) << (depth - 1);
+        if (hasElements & bit) {
+            out += ',';
+        }
+        hasElements |= bit;
+    }
+}
+
+void JsonWriter::open(char bracket) {
+    if (depth >= MAX_DEPTH) {
+        throw std::length_error("JSON nested too deeply");
+    }
+    separate();
+    out += bracket;
+    depth++;
+    hasElements &= ~(uint64_t(1) << (depth - 1));
+}
+
+void JsonWriter::close(char bracket) {
+    depth--;
+    out += bracket;
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    open('{');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    close('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    open('[');
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    close(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    separate();
+    appendEscaped(name);
+    out += ':';
+    afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view text) {
+    separate();
+    appendEscaped(text);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    out += flag ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double number) {
+    if (!std::isfinite(number)) {
+        return null();
+    }
+    separate();
+    char digits[32];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    out.append(digits, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::integer(int64_t number) {
+    separate();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    out.append(digits, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::unsignedInteger(uint64_t number) {
+    separate();
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), number);
+    out.append(digits, result.ptr);
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    out += "null";
+    return *this;
+}
+
+JsonWriter& JsonWriter::raw(std::string_view json) {
+    separate();
+    out += json;
+    return *this;
+}
+
+void JsonWriter::appendEscaped(std::string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+
+    out += '"';
+    // Copy runs of plain characters in one go, escaping only what JSON requires
+    size_t runStart = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        out.append(text.data() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 0xF];
+        }
+    }
+    out.append(text.data() + runStart, text.size() - runStart);
+    out += '"';
+}
+
+} // namespace velocore
@@ -0,0 +1,158 @@
+#include "LatencyHistogram.h"
+#include "Bits.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <sstream>
+
+namespace velocore {
+
+namespace {
+
+constexpr size_t STAGE_COUNT = static_cast<size_t>(LatencyStage::Count);
+
+// One thread's histograms; a thread owns a set until it exits
+struct ThreadHistograms {
+    std::array<LatencyHistogram, STAGE_COUNT> stages;
+    std::atomic<bool> inUse{false};
+};
+
+// Sets are never freed, so a deque keeps their addresses stable as it grows
+std::mutex registryMutex;
+std::deque<ThreadHistograms> registry;
+
+ThreadHistograms& acquireHistograms() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (ThreadHistograms& histograms : registry) {
+        if (!histograms.inUse.load(std::memory_order_acquire)) {
+            histograms.inUse.store(true, std::memory_order_relaxed);
+            return histograms;
+        }
+    }
+    registry.emplace_back();
+    registry.back().inUse.store(true, std::memory_order_relaxed);
+    return registry.back();
+}
+
+// Returns the thread's set to the registry when the thread exits
+struct HistogramLease {
+    ThreadHistograms& histograms = acquireHistograms();
+    ~HistogramLease() { histograms.inUse.store(false, std::memory_order_release); }
+};
+
+ThreadHistograms& threadHistograms() {
+    thread_local HistogramLease lease;
+    return lease.histograms;
+}
+
+} // namespace
+
+const char* to_string(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::RequestParse: return "request_parse";
+        case LatencyStage::Validation: return "validation";
+        case LatencyStage::LockWait: return "lock_wait";
+        case LatencyStage::Matching: return "matching";
+        case LatencyStage::Serialization: return "serialization";
+        case LatencyStage::OrderRequest: return "order_request";
+        default: return "unknown";
+    }
+}
+
+uint64_t LatencySnapshot::percentile(double quantile) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count)));
+    target = std::max<uint64_t>(1, std::min(target, count));
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < counts.size(); ++bucket) {
+        seen += counts[bucket];
+        if (seen >= target) {
+            return std::min(LatencyHistogram::bucketUpperBound(bucket), max);
+        }
+    }
+    return max;
+}
+
+size_t LatencyHistogram::bucketFor(uint64_t nanos) {
+    // Values below 2 * SUB_BUCKET_COUNT are exact; above, keep the top SUB_BUCKET_BITS + 1 bits
+    int highestBit = nanos == 0 ? 0 : static_cast<int>(highest_set_bit(nanos));
+    int shift = std::max(0, highestBit - SUB_BUCKET_BITS);
+    return (static_cast<size_t>(shift) << SUB_BUCKET_BITS) + static_cast<size_t>(nanos >> shift);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) {
+    int shift = bucket < 2 * SUB_BUCKET_COUNT ? 0 : static_cast<int>(bucket >> SUB_BUCKET_BITS) - 1;
+    uint64_t top = bucket - (static_cast<size_t>(shift) << SUB_BUCKET_BITS);
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    // Single writer, so plain load/store pairs are enough and avoid locked instructions
+    std::atomic<uint64_t>& bucket = counts[bucketFor(nanos)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum.store(sum.load(std::memory_order_relaxed) + nanos, std::memory_order_relaxed);
+    if (nanos > max.load(std::memory_order_relaxed)) {
+        max.store(nanos, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::mergeInto(LatencySnapshot& snapshot) const {
+    snapshot.counts.resize(BUCKET_COUNT, 0);
+    for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket) {
+        snapshot.counts[bucket] += counts[bucket].load(std::memory_order_relaxed);
+    }
+    snapshot.count += total.load(std::memory_order_relaxed);
+    snapshot.sum += sum.load(std::memory_order_relaxed);
+    snapshot.max = std::max(snapshot.max, max.load(std::memory_order_relaxed));
+}
+
+void record_latency(LatencyStage stage, std::chrono::nanoseconds duration) {
+    uint64_t nanos = duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0;
+    threadHistograms().stages[static_cast<size_t>(stage)].record(nanos);
+}
+
+LatencySnapshot latency_snapshot(LatencyStage stage) {
+    LatencySnapshot snapshot;
+    snapshot.counts.resize(LatencyHistogram::BUCKET_COUNT, 0);
+
+    // Only blocks threads recording for the first time
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const ThreadHistograms& histograms : registry) {
+        histograms.stages[static_cast<size_t>(stage)].mergeInto(snapshot);
+    }
+    return snapshot;
+}
+
+std::string latency_metrics_prometheus() {
+    static const std::pair<const char*, double> QUANTILES[] = {{"0.5", 0.5}, {"0.99", 0.99}, {"0.999", 0.999}};
+
+    std::ostringstream summary;
+    std::ostringstream maxima;
+    summary << "# HELP velocore_latency_nanoseconds Order path latency by stage\n"
+            << "# TYPE velocore_latency_nanoseconds summary\n";
+    maxima << "# HELP velocore_latency_max_nanoseconds Largest latency recorded by stage\n"
+           << "# TYPE velocore_latency_max_nanoseconds gauge\n";
+
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        LatencyStage stage = static_cast<LatencyStage>(i);
+        LatencySnapshot snapshot = latency_snapshot(stage);
+        std::string label = std::string("stage=\"") + to_string(stage) + "\"";
+
+        for (const auto& [name, quantile] : QUANTILES) {
+            summary << "velocore_latency_nanoseconds{" << label << ",quantile=\"" << name << "\"} "
+                    << snapshot.percentile(quantile) << "\n";
+        }
+        summary << "velocore_latency_nanoseconds_sum{" << label << "} " << snapshot.sum << "\n"
+                << "velocore_latency_nanoseconds_count{" << label << "} " << snapshot.count << "\n";
+        maxima << "velocore_latency_max_nanoseconds{" << label << "} " << snapshot.max << "\n";
+    }
+    return summary.str() + maxima.str();
+}
+
+} // namespace velocore
@@ -0,0 +1,265 @@
+#include "Logger.h"
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace velocore {
+
+namespace {
+
+// How long the logger thread sleeps when every ring is empty
+constexpr auto IDLE_WAIT = std::chrono::milliseconds(5);
+
+// Renders a record's arguments back to back, as operator<< would
+void formatPayload(const LogRecord& record, std::ostringstream& out) {
+    const char* data = record.payload;
+    const char* end = record.payload + record.size;
+
+    auto read = [&](auto& value) {
+        std::memcpy(&value, data, sizeof(value));
+        data += sizeof(value);
+    };
+
+    while (data < end) {
+        auto tag = static_cast<LogRecordWriter::Tag>(*data++);
+        switch (tag) {
+            case LogRecordWriter::Bool: { bool value; read(value); out << (value ? "true" : "false"); break; }
+            case LogRecordWriter::Char: { char value; read(value); out << value; break; }
+            case LogRecordWriter::Int: { int64_t value; read(value); out << value; break; }
+            case LogRecordWriter::UInt: { uint64_t value; read(value); out << value; break; }
+            case LogRecordWriter::Double: { double value; read(value); out << value; break; }
+            case LogRecordWriter::Symbol: { uint32_t value; read(value); out << SymbolId(value); break; }
+            case LogRecordWriter::String: {
+                uint16_t length;
+                read(length);
+                out.write(data, length);
+                data += length;
+                break;
+            }
+        }
+    }
+
+    if (record.truncated) {
+        out << "...";
+    }
+}
+
+void formatTime(Clock::time_point time, std::ostringstream& out) {
+    auto wallTime = Clock::toSystem(time);
+    std::time_t seconds = std::chrono::system_clock::to_time_t(wallTime);
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(wallTime.time_since_epoch()).count() % 1000;
+
+    // Both reentrant, so concurrent log calls never share the C library's static tm
+    std::tm local{};
+#if defined(_WIN32)
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    out << std::put_time(&local, "%Y-%m-%d %H:%M:%S") << '.' << std::setfill('0') << std::setw(3) << millis
+        << std::setfill(' ');
+}
+
+} // namespace
+
+LogLevel log_level_from_string(const std::string& level) {
+    std::string name = level;
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::toupper(c); });
+
+    if (name == "DEBUG") return LogLevel::Debug;
+    if (name == "WARN" || name == "WARNING") return LogLevel::Warn;
+    if (name == "ERROR") return LogLevel::Error;
+    if (name == "OFF" || name == "NONE") return LogLevel::Off;
+    return LogLevel::Info;
+}
+
+const char* to_string(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        default: return "OFF";
+    }
+}
+
+void LogRecordWriter::put(std::string_view value) {
+    // Tag and 16-bit length, then as much of the text as fits
+    constexpr size_t HEADER_BYTES = 1 + sizeof(uint16_t);
+    if (record.size + HEADER_BYTES >= LogRecord::PAYLOAD_BYTES) {
+        record.truncated = true;
+        return;
+    }
+
+    size_t room = LogRecord::PAYLOAD_BYTES - record.size - HEADER_BYTES;
+    uint16_t length = static_cast<uint16_t>(std::min(value.size(), room));
+    if (length < value.size()) {
+        record.truncated = true;
+    }
+
+    record.payload[record.size] = static_cast<char>(String);
+    std::memcpy(record.payload + record.size + 1, &length, sizeof(length));
+    std::memcpy(record.payload + record.size + HEADER_BYTES, value.data(), length);
+    record.size = static_cast<uint16_t>(record.size + HEADER_BYTES + length);
+}
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : sink(&std::cout) {
+    worker = std::thread([this]() { run(); });
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wakeCondition.notify_one();
+    worker.join();
+}
+
+Logger::RingLease::~RingLease() {
+    // Records still queued are written out later, then the ring can be handed to a new thread
+    if (ring) {
+        ring->inUse.store(false, std::memory_order_release);
+    }
+}
+
+Logger::Ring& Logger::threadRing() {
+    thread_local RingLease lease;
+    if (lease.ring) {
+        return *lease.ring;
+    }
+
+    // Take over a ring left by a finished thread once it has been drained, so the new thread gets all of it
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    for (Ring& ring : rings) {
+        if (!ring.inUse.load(std::memory_order_acquire) &&
+            ring.tail.load(std::memory_order_acquire) == ring.head.load(std::memory_order_relaxed)) {
+            lease.ring = &ring;
+            break;
+        }
+    }
+    if (!lease.ring) {
+        lease.ring = &rings.emplace_back();
+    }
+    lease.ring->inUse.store(true, std::memory_order_relaxed);
+    return *lease.ring;
+}
+
+LogRecord* Logger::claim() {
+    Ring& ring = threadRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+        // Never wait for the logger thread, drop the message instead
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &ring.records[head & (RING_CAPACITY - 1)];
+}
+
+void Logger::publish() {
+    Ring& ring = threadRing();
+    ring.head.store(ring.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void Logger::setSink(std::ostream& newSink) {
+    flush();
+
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    sink = &newSink;
+
+    // Wait out a pass that started with the old sink, so it is no longer used once we return
+    uint64_t request = ++flushRequests;
+    wakeCondition.notify_one();
+    flushedCondition.wait(lock, [&]() { return flushesDone >= request; });
+}
+
+void Logger::flush() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    uint64_t request = ++flushRequests;
+    wakeCondition.notify_one();
+    flushedCondition.wait(lock, [&]() { return flushesDone >= request; });
+}
+
+bool Logger::drain() {
+    // Only the list is guarded; rings are drained without holding any lock
+    std::vector<Ring*> current;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (Ring& ring : rings) {
+            current.push_back(&ring);
+        }
+    }
+
+    std::ostringstream text;
+    bool wrote = false;
+
+    uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+    if (droppedNow != reportedDropped) {
+        text << "WARN  Logger dropped " << (droppedNow - reportedDropped) << " messages\n";
+        reportedDropped = droppedNow;
+        wrote = true;
+    }
+
+    for (Ring* ring : current) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            const LogRecord& record = ring->records[tail & (RING_CAPACITY - 1)];
+            formatTime(record.time, text);
+            text << ' ' << std::left << std::setw(5) << to_string(record.level) << ' ';
+            formatPayload(record, text);
+            text << '\n';
+            wrote = true;
+        }
+
+        // Hand the slots back to the producer
+        ring->tail.store(tail, std::memory_order_release);
+    }
+
+    if (wrote) {
+        std::ostream* out;
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            out = sink;
+        }
+        // One write and one flush per batch
+        *out << text.str();
+        out->flush();
+    }
+    return wrote;
+}
+
+void Logger::run() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (true) {
+        // Everything queued before these were read is written by this pass
+        uint64_t request = flushRequests;
+        bool stop = stopping;
+
+        lock.unlock();
+        bool wrote = drain();
+        lock.lock();
+
+        if (request > flushesDone) {
+            flushesDone = request;
+            flushedCondition.notify_all();
+        }
+        if (stop) {
+            return;
+        }
+        if (!wrote) {
+            wakeCondition.wait_for(lock, IDLE_WAIT, [&]() { return stopping || flushRequests > flushesDone; });
+        }
+    }
+}
+
+} // namespace velocore
@@ -1,11 +1,12 @@
 #include "Order.h"
+#include "Clock.h"
 #include <stdexcept>
 
 namespace velocore {
 
 std::atomic<uint64_t> Order::id_counter{1};
 
-Order::Order(uint64_t client_id, const std::string& symbol, Side side, OrderType type, double price, int quantity)
+Order::Order(uint64_t client_id, SymbolId symbol, Side side, OrderType type, Price price, int quantity)
     : id(generate_id())
     , client_id(client_id)
     , symbol(symbol)
@@ -15,10 +16,19 @@ Order::Order(uint64_t client_id, const std::string& symbol, Side side, OrderType
     , quantity(quantity)
     , remaining_quantity(quantity)
     , status(OrderStatus::Active)
-    , timestamp(std::chrono::steady_clock::now()) {}
+    , sequence(0)
+    , timestamp(Clock::now()) {}
 
 uint64_t Order::generate_id() {
-    return id_counter.fetch_add(1);
+    // Ids left in this thread's current block
+    thread_local uint64_t nextId = 0;
+    thread_local uint64_t blockEnd = 0;
+    
+    if (nextId == blockEnd) {
+        nextId = id_counter.fetch_add(ORDER_ID_BLOCK, std::memory_order_relaxed);
+        blockEnd = nextId + ORDER_ID_BLOCK;
+    }
+    return nextId++;
 }
 
 void Order::fill(int fill_qty) {
@@ -42,36 +52,53 @@ void Order::cancel() {
 }
 
 crow::json::wvalue Order::to_json() const {
-    auto duration = timestamp.time_since_epoch();
-    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-    
     return crow::json::wvalue{
         {"id", static_cast<int64_t>(id)},
         {"client_id", static_cast<int64_t>(client_id)},
-        {"symbol", symbol},
+        {"symbol", symbol_name(symbol)},
         {"side", to_string(side)},
         {"type", to_string(type)},
-        {"price", price},
+        {"price", price.to_double(tick_size_for(symbol))},
         {"quantity", quantity},
         {"remaining_quantity", remaining_quantity},
         {"filled_quantity", filled_quantity()},
         {"fill_percentage", fill_percentage()},
         {"status", to_string(status)},
-        {"timestamp", millis}
+        {"sequence", static_cast<int64_t>(sequence)},
+        {"timestamp", Clock::toUnixMillis(timestamp)}
     };
 }
 
+void Order::write_json(JsonWriter& writer) const {
+    writer.beginObject()
+        .field("id", id)
+        .field("client_id", client_id)
+        .field("symbol", symbol_name(symbol))
+        .field("side", to_string(side))
+        .field("type", to_string(type))
+        .field("price", price.to_double(tick_size_for(symbol)))
+        .field("quantity", quantity)
+        .field("remaining_quantity", remaining_quantity)
+        .field("filled_quantity", filled_quantity())
+        .field("fill_percentage", fill_percentage())
+        .field("status", to_string(status))
+        .field("sequence", sequence)
+        .field("timestamp", Clock::toUnixMillis(timestamp))
+        .endObject();
+}
+
 Order Order::from_json(const crow::json::rvalue& json) {
     Order order;
     order.client_id = json["client_id"].u();
-    order.symbol = json["symbol"].s();
+    order.symbol = intern_symbol(json["symbol"].s());
     order.side = side_from_string(json["side"].s());
     order.type = order_type_from_string(json["type"].s());
-    order.price = json["price"].d();
+    order.price = Price::from_double(json["price"].d(), tick_size_for(order.symbol));
     order.quantity = json["quantity"].i();
     order.remaining_quantity = order.quantity;
     order.status = OrderStatus::Active;
-    order.timestamp = std::chrono::steady_clock::now();
+    order.sequence = 0;
+    order.timestamp = Clock::now();
     order.id = generate_id();
     return order;
 }
@@ -91,7 +118,8 @@ bool operator<(const Order& lhs, const Order& rhs) {
         }
     }
     
-    return lhs.timestamp < rhs.timestamp;
+    // Same side and price - the book's entry sequence breaks the tie, never the clock
+    return lhs.sequence < rhs.sequence;
 }
 
 } 
\ No newline at end of file
@@ -1,241 +1,331 @@
 #include "OrderBook.h"
+#include "Clock.h"
+#include "LatencyHistogram.h"
 #include <algorithm>
 #include <stdexcept>
 #include <limits>
 
 namespace velocore {
 
-OrderBook::OrderBook() : nextTradeId(1) {}
+template<template<typename> class Levels, typename MatchingPolicy>
+BasicOrderBook<Levels, MatchingPolicy>::BasicOrderBook(double tickSize, size_t tradeLogCapacity,
+                                                       const std::string& tradeSpillPath, SymbolId symbol)
+    : tickSize(tickSize)
+    , bookSymbol(symbol)
+    , nextSequence(1)
+    , nextTradeId(1)
+    , tradeLog(tradeLogCapacity, tradeSpillPath) {}
 
-std::vector<Trade> OrderBook::addOrder(Order order) {
+template<template<typename> class Levels, typename MatchingPolicy>
+std::vector<Trade> BasicOrderBook<Levels, MatchingPolicy>::addOrder(Order order) {
+    std::vector<Trade> trades;
+    addOrder(order, trades);
+    return trades;
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+size_t BasicOrderBook<Levels, MatchingPolicy>::addOrder(const Order& order, std::vector<Trade>& executions) {
     // Write operation - acquire exclusive lock
+    Clock::time_point waitStart = Clock::now();
+    std::unique_lock<std::shared_mutex> lock(bookMutex);
+    Clock::time_point lockedAt = Clock::now();
+    record_latency(LatencyStage::LockWait, std::chrono::duration_cast<std::chrono::nanoseconds>(lockedAt - waitStart));
+    
+    // Match a copy held in a reused slot so the caller's order stays untouched
+    incomingOrder = order;
+    size_t before = executions.size();
+    processOrder(incomingOrder, executions);
+    publishTopOfBook();
+    record_latency(LatencyStage::Matching, lockedAt);
+    return executions.size() - before;
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+std::vector<std::vector<Trade>> BasicOrderBook<Levels, MatchingPolicy>::addOrders(const std::vector<Order>& orders) {
+    // Write operation - acquire exclusive lock once for the whole batch
+    Clock::time_point waitStart = Clock::now();
     std::unique_lock<std::shared_mutex> lock(bookMutex);
+    Clock::time_point lockedAt = Clock::now();
+    record_latency(LatencyStage::LockWait, std::chrono::duration_cast<std::chrono::nanoseconds>(lockedAt - waitStart));
+    
+    std::vector<std::vector<Trade>> results(orders.size());
+    for (size_t i = 0; i < orders.size(); ++i) {
+        incomingOrder = orders[i];
+        processOrder(incomingOrder, results[i]);
+    }
+    
+    // Readers only ever see the book after the whole batch
+    publishTopOfBook();
+    record_latency(LatencyStage::Matching, lockedAt);
+    return results;
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+void BasicOrderBook<Levels, MatchingPolicy>::processOrder(Order& order, std::vector<Trade>& executions) {
+    // Time priority is the order of entry into this book, not a clock reading
+    order.sequence = nextSequence++;
     
     // Set order timestamp if not already set
     if (order.timestamp == std::chrono::steady_clock::time_point{}) {
-        order.timestamp = std::chrono::steady_clock::now();
+        order.timestamp = Clock::now();
     }
     
     // Attempt to match the order
-    std::vector<Trade> trades = matchOrder(order);
+    matchOrder(order, executions);
     
     // If it's a limit order and has remaining quantity, add it to the book
     if (order.is_limit() && order.remaining_quantity > 0) {
         addToBook(order);
     }
-    
-    return trades;
 }
 
-std::vector<Trade> OrderBook::matchOrder(Order& order) {
+template<template<typename> class Levels, typename MatchingPolicy>
+void BasicOrderBook<Levels, MatchingPolicy>::matchOrder(Order& order, std::vector<Trade>& executions) {
+    // Pick the side once, everything inside the loop is resolved at compile time
     if (order.is_buy()) {
-        return matchBuyOrder(order);
+        matchAgainst<BuySide>(order, sellBook, sellTotals, executions);
     } else {
-        return matchSellOrder(order);
+        matchAgainst<SellSide>(order, buyBook, buyTotals, executions);
     }
 }
 
-std::vector<Trade> OrderBook::matchBuyOrder(Order& buyOrder) {
-    std::vector<Trade> trades;
+template<template<typename> class Levels, typename MatchingPolicy>
+template<typename SideTraits, typename BookType>
+void BasicOrderBook<Levels, MatchingPolicy>::matchAgainst(Order& incoming, BookType& book, SideTotals& totals,
+                                                          std::vector<Trade>& executions) {
+    Price limit = incoming.is_market() ? SideTraits::marketLimit() : incoming.price;
     
-    // Match against sell book
-    while (buyOrder.remaining_quantity > 0 && !sellBook.empty()) {
-        auto& [askPrice, askQueue] = *sellBook.begin();
+    while (incoming.remaining_quantity > 0 && !book.empty()) {
+        Price levelPrice = book.bestPrice();
         
         // Check if prices cross
-        if (buyOrder.is_market() || pricesCross(buyOrder.price, askPrice)) {
-            // Get the oldest order at this price level
-            Order& sellOrder = askQueue.front();
-            
-            double executionPrice = askPrice;
-            
-            // Determine execution quantity
-            int executeQty = std::min(buyOrder.remaining_quantity, sellOrder.remaining_quantity);
-            
-            // Execute the trade
-            Trade trade = executeTrade(buyOrder, sellOrder, executionPrice, executeQty);
-            trades.push_back(trade);
-            tradeLog.push_back(trade);
-            
-            // Update order quantities
-            buyOrder.remaining_quantity -= executeQty;
-            sellOrder.remaining_quantity -= executeQty;
-            
-            // Update order statuses
-            if (buyOrder.remaining_quantity == 0) {
-                buyOrder.status = OrderStatus::Filled;
-            } else if (buyOrder.remaining_quantity < buyOrder.quantity) {
-                buyOrder.status = OrderStatus::PartiallyFilled;
-            }
-            
-            if (sellOrder.remaining_quantity == 0) {
-                sellOrder.status = OrderStatus::Filled;
-                // Remove completely filled order from the book
-                askQueue.pop_front();
-                // If price level is now empty, remove it entirely
-                if (askQueue.empty()) {
-                    sellBook.erase(sellBook.begin());
-                }
-            } else {
-                sellOrder.status = OrderStatus::PartiallyFilled;
-            }
-        } else {
+        if (!SideTraits::crosses(limit, levelPrice)) {
             // Prices don't cross, no more matches possible
             break;
         }
-    }
-    
-    return trades;
-}
-
-std::vector<Trade> OrderBook::matchSellOrder(Order& sellOrder) {
-    std::vector<Trade> trades;
-    
-    // Match against buy book
-    while (sellOrder.remaining_quantity > 0 && !buyBook.empty()) {
-        auto& [bidPrice, bidQueue] = *buyBook.begin();
         
-        // Check if prices cross
-        if (sellOrder.is_market() || pricesCross(bidPrice, sellOrder.price)) {
-            // Get the oldest order at this level
-            Order& buyOrder = bidQueue.front();
-            
-            // Determine execution price
-            double executionPrice = bidPrice;
-            
-            // Determine execution quantity
-            int executeQty = std::min(sellOrder.remaining_quantity, buyOrder.remaining_quantity);
+        PriceLevel& level = book.best();
+        
+        // The policy decides which resting orders trade and how much each gets
+        MatchingPolicy::allocate(level, incoming.remaining_quantity, [&](OrderNode* restingNode, int executeQty) {
+            // Only the resting order's hot record is touched here
+            OrderNode& resting = *restingNode;
             
-            // Execute the trade
-            Trade trade = executeTrade(buyOrder, sellOrder, executionPrice, executeQty);
-            trades.push_back(trade);
-            tradeLog.push_back(trade);
+            // Execute the trade at the resting order's price
+            Trade trade = executeTrade(SideTraits::buyerId(incoming, resting), SideTraits::sellerId(incoming, resting),
+                                       incoming.symbol, levelPrice, executeQty);
+            executions.push_back(trade);
+            tradeLog.append(trade);
+            analytics.add(trade);
             
             // Update order quantities
-            sellOrder.remaining_quantity -= executeQty;
-            buyOrder.remaining_quantity -= executeQty;
+            incoming.remaining_quantity -= executeQty;
+            resting.remaining_quantity -= executeQty;
+            level.reduce(executeQty);
+            totals.quantity -= executeQty;
             
             // Update order statuses
-            if (sellOrder.remaining_quantity == 0) {
-                sellOrder.status = OrderStatus::Filled;
-            } else if (sellOrder.remaining_quantity < sellOrder.quantity) {
-                sellOrder.status = OrderStatus::PartiallyFilled;
+            if (incoming.remaining_quantity == 0) {
+                incoming.status = OrderStatus::Filled;
+            } else if (incoming.remaining_quantity < incoming.quantity) {
+                incoming.status = OrderStatus::PartiallyFilled;
             }
             
-            if (buyOrder.remaining_quantity == 0) {
-                buyOrder.status = OrderStatus::Filled;
-                // Remove completely filled order from the book
-                bidQueue.pop_front();
-                // If price level is now empty, remove it entirely
-                if (bidQueue.empty()) {
-                    buyBook.erase(buyBook.begin());
-                }
-            } else {
-                buyOrder.status = OrderStatus::PartiallyFilled;
+            // A resting order's status is derived from its quantities (see findOrder)
+            if (resting.remaining_quantity == 0) {
+                // Remove completely filled order from the book and the index
+                orderIndex.erase(resting.id);
+                level.erase(restingNode);
+                orderPool.release(restingNode);
+                totals.orders--;
             }
-        } else {
-            // Prices don't cross, no more matches possible
-            break;
+        });
+        
+        // If price level is now empty, remove it entirely
+        if (level.empty()) {
+            book.erase(levelPrice);
         }
     }
-    
-    return trades;
 }
 
-Trade OrderBook::executeTrade(Order& buyOrder, Order& sellOrder, double executionPrice, int quantity) {
+template<template<typename> class Levels, typename MatchingPolicy>
+Trade BasicOrderBook<Levels, MatchingPolicy>::executeTrade(uint64_t buyOrderId, uint64_t sellOrderId, SymbolId symbol,
+                                                           Price executionPrice, int quantity) {
+    topOfBook.last_trade_price = executionPrice;
+    topOfBook.last_trade_quantity = quantity;
+    
+    // Ids come from this book's own sequence, so matching never touches a shared counter
     return Trade(
-        buyOrder.id,
-        sellOrder.id,
-        buyOrder.symbol,  // Assuming both orders have the same symbol
+        make_trade_id(bookSymbol, nextTradeId++),
+        buyOrderId,
+        sellOrderId,
+        symbol,
         executionPrice,
         quantity
     );
 }
 
-void OrderBook::addToBook(const Order& order) {
-    if (order.is_buy()) {
-        buyBook[order.price].push_back(order);
-    } else {
-        sellBook[order.price].push_back(order);
-    }
+template<template<typename> class Levels, typename MatchingPolicy>
+void BasicOrderBook<Levels, MatchingPolicy>::addToBook(const Order& order) {
+    PriceLevel& level = order.is_buy() ? buyBook[order.price] : sellBook[order.price];
+    OrderNode* node = orderPool.acquire(order);
+    level.push_back(node);
+    orderIndex.insert(order.id, node);
+    
+    SideTotals& totals = order.is_buy() ? buyTotals : sellTotals;
+    totals.orders++;
+    totals.quantity += order.remaining_quantity;
 }
 
+template<template<typename> class Levels, typename MatchingPolicy>
 template<typename BookType>
-void OrderBook::removeFromPriceLevel(BookType& book, double price) {
-    auto it = book.find(price);
-    if (it != book.end()) {
-        it->second.pop_front();
-        if (it->second.empty()) {
-            book.erase(it);
+void BasicOrderBook<Levels, MatchingPolicy>::removeFromPriceLevel(BookType& book, OrderNode* node) {
+    const Order& details = orderPool.details(node);
+    Price price = details.price;
+    PriceLevel* level = book.find(price);
+    if (level) {
+        SideTotals& totals = details.is_buy() ? buyTotals : sellTotals;
+        totals.orders--;
+        totals.quantity -= node->remaining_quantity;
+        
+        orderIndex.erase(node->id);
+        level->erase(node);
+        orderPool.release(node);
+        if (level->empty()) {
+            book.erase(price);
         }
     }
 }
 
-bool OrderBook::pricesCross(double buyPrice, double sellPrice) const {
-    return buyPrice >= sellPrice;
+template<template<typename> class Levels, typename MatchingPolicy>
+void BasicOrderBook<Levels, MatchingPolicy>::publishTopOfBook() {
+    if (buyBook.empty()) {
+        topOfBook.bid_price = Price();
+        topOfBook.bid_quantity = 0;
+    } else {
+        topOfBook.bid_price = buyBook.bestPrice();
+        topOfBook.bid_quantity = buyBook.best().quantity();
+    }
+    
+    if (sellBook.empty()) {
+        topOfBook.ask_price = Price();
+        topOfBook.ask_quantity = 0;
+    } else {
+        topOfBook.ask_price = sellBook.bestPrice();
+        topOfBook.ask_quantity = sellBook.best().quantity();
+    }
+    
+    topOfBook.sequence++;
+    publishedTop.store(topOfBook);
 }
 
-bool OrderBook::cancelOrder(uint64_t orderId) {
+template<template<typename> class Levels, typename MatchingPolicy>
+bool BasicOrderBook<Levels, MatchingPolicy>::cancelOrder(uint64_t orderId) {
     // Write operation - acquire exclusive lock
     std::unique_lock<std::shared_mutex> lock(bookMutex);
     
-    // Search in buy book
-    for (auto& [price, orders] : buyBook) {
-        for (auto it = orders.begin(); it != orders.end(); ++it) {
-            if (it->id == orderId) {
-                it->cancel();
-                orders.erase(it);
-                if (orders.empty()) {
-                    buyBook.erase(price);
-                }
-                return true;
-            }
-        }
+    OrderNode* node = orderIndex.find(orderId);
+    if (!node) {
+        return false;
     }
     
-    // Search in sell book
-    for (auto& [price, orders] : sellBook) {
-        for (auto it = orders.begin(); it != orders.end(); ++it) {
-            if (it->id == orderId) {
-                it->cancel();
-                orders.erase(it);
-                if (orders.empty()) {
-                    sellBook.erase(price);
-                }
-                return true;
-            }
-        }
+    if (orderPool.details(node).is_buy()) {
+        removeFromPriceLevel(buyBook, node);
+    } else {
+        removeFromPriceLevel(sellBook, node);
     }
     
-    return false;
-}
-
-double OrderBook::getBestBid() const {
-    // Read operation - acquire shared lock
-    std::shared_lock<std::shared_mutex> lock(bookMutex);
-    return buyBook.empty() ? 0.0 : buyBook.begin()->first;
+    publishTopOfBook();
+    return true;
 }
 
-double OrderBook::getBestAsk() const {
-    // Read operation - acquire shared lock
-    std::shared_lock<std::shared_mutex> lock(bookMutex);
-    return sellBook.empty() ? 0.0 : sellBook.begin()->first;
+template<template<typename> class Levels, typename MatchingPolicy>
+std::optional<std::vector<Trade>> BasicOrderBook<Levels, MatchingPolicy>::amendOrder(uint64_t orderId, Price newPrice, int newQuantity) {
+    // Write operation - acquire exclusive lock
+    std::unique_lock<std::shared_mutex> lock(bookMutex);
+    
+    OrderNode* node = orderIndex.find(orderId);
+    if (!node) {
+        return std::nullopt;
+    }
+    
+    Order& order = orderPool.details(node);
+    int filledQuantity = order.quantity - node->remaining_quantity;
+    if (newPrice <= Price()) {
+        throw std::invalid_argument("Amended price must be greater than 0");
+    }
+    if (newQuantity <= filledQuantity) {
+        throw std::invalid_argument("Amended quantity must exceed the filled quantity");
+    }
+    
+    int newRemaining = newQuantity - filledQuantity;
+    std::vector<Trade> trades;
+    
+    if (newPrice == order.price && newRemaining <= node->remaining_quantity) {
+        // Quantity down at the same price - shrink in place and keep queue position
+        int reduction = node->remaining_quantity - newRemaining;
+        PriceLevel* level = order.is_buy() ? buyBook.find(order.price) : sellBook.find(order.price);
+        level->reduce(reduction);
+        (order.is_buy() ? buyTotals : sellTotals).quantity -= reduction;
+        order.quantity = newQuantity;
+        node->remaining_quantity = newRemaining;
+    } else {
+        // Price change or quantity up - pull the order and re-enter it with fresh time priority
+        incomingOrder = order;
+        if (order.is_buy()) {
+            removeFromPriceLevel(buyBook, node);
+        } else {
+            removeFromPriceLevel(sellBook, node);
+        }
+        
+        incomingOrder.price = newPrice;
+        incomingOrder.quantity = newQuantity;
+        incomingOrder.remaining_quantity = newRemaining;
+        incomingOrder.timestamp = Clock::now();
+        processOrder(incomingOrder, trades);
+    }
+    
+    publishTopOfBook();
+    return trades;
 }
 
-double OrderBook::getSpread() const {
+template<template<typename> class Levels, typename MatchingPolicy>
+std::optional<Order> BasicOrderBook<Levels, MatchingPolicy>::findOrder(uint64_t orderId) const {
     // Read operation - acquire shared lock
     std::shared_lock<std::shared_mutex> lock(bookMutex);
-    double bestBid = buyBook.empty() ? 0.0 : buyBook.begin()->first;
-    double bestAsk = sellBook.empty() ? 0.0 : sellBook.begin()->first;
     
-    if (bestBid == 0.0 || bestAsk == 0.0) {
-        return 0.0;
+    const OrderNode* node = orderIndex.find(orderId);
+    if (!node) {
+        return std::nullopt;
     }
     
-    return bestAsk - bestBid;
+    // Rebuild the full order from the cold details and the live hot record
+    Order order = orderPool.details(node);
+    order.remaining_quantity = node->remaining_quantity;
+    order.status = (order.remaining_quantity < order.quantity) ? OrderStatus::PartiallyFilled : OrderStatus::Active;
+    return order;
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+Price BasicOrderBook<Levels, MatchingPolicy>::getBestBid() const {
+    // Read operation - published top of book, no lock
+    return publishedTop.load().bid_price;
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+Price BasicOrderBook<Levels, MatchingPolicy>::getBestAsk() const {
+    // Read operation - published top of book, no lock
+    return publishedTop.load().ask_price;
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+Price BasicOrderBook<Levels, MatchingPolicy>::getSpread() const {
+    // Read operation - published top of book, no lock
+    return publishedTop.load().spread();
 }
 
-crow::json::wvalue OrderBook::getBookSnapshot(size_t levels) const {
+template<template<typename> class Levels, typename MatchingPolicy>
+crow::json::wvalue BasicOrderBook<Levels, MatchingPolicy>::getBookSnapshot(size_t levels) const {
     // Read operation - acquire shared lock
     std::shared_lock<std::shared_mutex> lock(bookMutex);
     
@@ -244,124 +334,217 @@ crow::json::wvalue OrderBook::getBookSnapshot(size_t levels) const {
     
     // Get bid levels
     size_t bidCount = 0;
-    for (const auto& [price, orders] : buyBook) {
-        if (bidCount >= levels) break;
-        
-        int totalQty = 0;
-        for (const auto& order : orders) {
-            totalQty += order.remaining_quantity;
-        }
+    buyBook.forEach([&](Price price, const PriceLevel& orders) {
+        if (bidCount >= levels) return false;
         
         bids.push_back(crow::json::wvalue{
-            {"price", price},
-            {"quantity", totalQty},
+            {"price", price.to_double(tickSize)},
+            {"quantity", orders.quantity()},
             {"orders", static_cast<int>(orders.size())}
         });
         
         bidCount++;
-    }
+        return true;
+    });
     
     // Get ask levels
     size_t askCount = 0;
-    for (const auto& [price, orders] : sellBook) {
-        if (askCount >= levels) break;
-        
-        int totalQty = 0;
-        for (const auto& order : orders) {
-            totalQty += order.remaining_quantity;
-        }
+    sellBook.forEach([&](Price price, const PriceLevel& orders) {
+        if (askCount >= levels) return false;
         
         asks.push_back(crow::json::wvalue{
-            {"price", price},
-            {"quantity", totalQty},
+            {"price", price.to_double(tickSize)},
+            {"quantity", orders.quantity()},
             {"orders", static_cast<int>(orders.size())}
         });
         
         askCount++;
-    }
+        return true;
+    });
     
     result["bids"] = std::move(bids);
     result["asks"] = std::move(asks);
     
     // Calculate spread and best prices (we already have the lock)
-    double bestBid = buyBook.empty() ? 0.0 : buyBook.begin()->first;
-    double bestAsk = sellBook.empty() ? 0.0 : sellBook.begin()->first;
-    double spread = (bestBid == 0.0 || bestAsk == 0.0) ? 0.0 : bestAsk - bestBid;
+    Price bestBid = buyBook.empty() ? Price() : buyBook.bestPrice();
+    Price bestAsk = sellBook.empty() ? Price() : sellBook.bestPrice();
+    Price spread = (buyBook.empty() || sellBook.empty()) ? Price() : bestAsk - bestBid;
     
-    result["spread"] = spread;
-    result["best_bid"] = bestBid;
-    result["best_ask"] = bestAsk;
+    result["spread"] = spread.to_double(tickSize);
+    result["best_bid"] = bestBid.to_double(tickSize);
+    result["best_ask"] = bestAsk.to_double(tickSize);
     
     return result;
 }
 
-std::vector<Trade> OrderBook::getTradeLog() const {
+template<template<typename> class Levels, typename MatchingPolicy>
+std::vector<Trade> BasicOrderBook<Levels, MatchingPolicy>::getTradeLog() const {
     // Read operation - acquire shared lock
     std::shared_lock<std::shared_mutex> lock(bookMutex);
-    return tradeLog;
+    return std::vector<Trade>(tradeLog.begin(), tradeLog.end());
 }
 
-crow::json::wvalue OrderBook::getBookStatistics() const {
+template<template<typename> class Levels, typename MatchingPolicy>
+std::optional<Trade> BasicOrderBook<Levels, MatchingPolicy>::findTrade(uint64_t tradeId) const {
     // Read operation - acquire shared lock
     std::shared_lock<std::shared_mutex> lock(bookMutex);
     
-    int totalBidLevels = buyBook.size();
-    int totalAskLevels = sellBook.size();
-    int totalBidOrders = 0;
-    int totalAskOrders = 0;
+    const Trade* trade = tradeLog.find(tradeId);
+    if (!trade) {
+        return std::nullopt;
+    }
+    return *trade;
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+std::vector<Trade> BasicOrderBook<Levels, MatchingPolicy>::getTradesSince(uint64_t sinceId, size_t limit) const {
+    // Read operation - acquire shared lock
+    std::shared_lock<std::shared_mutex> lock(bookMutex);
+    
+    size_t first = tradeLog.lowerBound(sinceId + 1);
+    size_t last = first + std::min(limit, tradeLog.size() - first);
     
-    for (const auto& [price, orders] : buyBook) {
-        totalBidOrders += orders.size();
+    std::vector<Trade> trades;
+    trades.reserve(last - first);
+    for (size_t position = first; position < last; ++position) {
+        trades.push_back(tradeLog[position]);
     }
+    return trades;
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+std::vector<Trade> BasicOrderBook<Levels, MatchingPolicy>::getTradesAfter(const Trade& cursor, size_t limit) const {
+    // Read operation - acquire shared lock
+    std::shared_lock<std::shared_mutex> lock(bookMutex);
+    
+    size_t first = tradeLog.upperBound(cursor);
+    size_t last = first + std::min(limit, tradeLog.size() - first);
     
-    for (const auto& [price, orders] : sellBook) {
-        totalAskOrders += orders.size();
+    std::vector<Trade> trades;
+    trades.reserve(last - first);
+    for (size_t position = first; position < last; ++position) {
+        trades.push_back(tradeLog[position]);
     }
+    return trades;
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+void BasicOrderBook<Levels, MatchingPolicy>::writeBookSnapshot(JsonWriter& writer, size_t levels) const {
+    // Read operation - acquire shared lock
+    std::shared_lock<std::shared_mutex> lock(bookMutex);
+    
+    auto writeLevels = [&](const auto& book) {
+        size_t count = 0;
+        writer.beginArray();
+        book.forEach([&](Price price, const PriceLevel& orders) {
+            if (count >= levels) return false;
+            
+            writer.beginObject()
+                .field("price", price.to_double(tickSize))
+                .field("quantity", orders.quantity())
+                .field("orders", orders.size())
+                .endObject();
+            
+            count++;
+            return true;
+        });
+        writer.endArray();
+    };
+    
+    Price bestBid = buyBook.empty() ? Price() : buyBook.bestPrice();
+    Price bestAsk = sellBook.empty() ? Price() : sellBook.bestPrice();
+    Price spread = (buyBook.empty() || sellBook.empty()) ? Price() : bestAsk - bestBid;
+    
+    writer.beginObject();
+    writer.key("bids");
+    writeLevels(buyBook);
+    writer.key("asks");
+    writeLevels(sellBook);
+    writer.field("spread", spread.to_double(tickSize))
+        .field("best_bid", bestBid.to_double(tickSize))
+        .field("best_ask", bestAsk.to_double(tickSize))
+        .endObject();
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+crow::json::wvalue BasicOrderBook<Levels, MatchingPolicy>::getBookStatistics() const {
+    // Read operation - acquire shared lock
+    std::shared_lock<std::shared_mutex> lock(bookMutex);
+    
+    int totalBidLevels = buyBook.size();
+    int totalAskLevels = sellBook.size();
+    int totalBidOrders = static_cast<int>(buyTotals.orders);
+    int totalAskOrders = static_cast<int>(sellTotals.orders);
     
     return crow::json::wvalue{
         {"bid_levels", totalBidLevels},
         {"ask_levels", totalAskLevels},
         {"bid_orders", totalBidOrders},
         {"ask_orders", totalAskOrders},
+        {"bid_quantity", buyTotals.quantity},
+        {"ask_quantity", sellTotals.quantity},
         {"total_orders", totalBidOrders + totalAskOrders},
-        {"total_trades", static_cast<int>(tradeLog.size())}
+        {"total_trades", static_cast<int>(tradeLog.totalCount())}
     };
 }
 
-void OrderBook::clear() {
+template<template<typename> class Levels, typename MatchingPolicy>
+crow::json::wvalue BasicOrderBook<Levels, MatchingPolicy>::getAnalytics() const {
+    // Read operation - acquire shared lock
+    std::shared_lock<std::shared_mutex> lock(bookMutex);
+    return analytics.to_json(tickSize, Clock::now());
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+WindowSummary BasicOrderBook<Levels, MatchingPolicy>::getWindowSummary(size_t window) const {
+    // Read operation - acquire shared lock
+    std::shared_lock<std::shared_mutex> lock(bookMutex);
+    return analytics.summary(window, Clock::now());
+}
+
+template<template<typename> class Levels, typename MatchingPolicy>
+void BasicOrderBook<Levels, MatchingPolicy>::clear() {
     // Write operation - acquire exclusive lock
     std::unique_lock<std::shared_mutex> lock(bookMutex);
     buyBook.clear();
     sellBook.clear();
+    orderIndex.clear();
+    orderPool.releaseAll();
+    buyTotals = SideTotals{};
+    sellTotals = SideTotals{};
+    topOfBook.last_trade_price = Price();
+    topOfBook.last_trade_quantity = 0;
     tradeLog.clear();
-    nextTradeId = 1;
+    analytics.clear();
+    publishTopOfBook();
 }
 
-size_t OrderBook::getTotalOrders() const {
+template<template<typename> class Levels, typename MatchingPolicy>
+size_t BasicOrderBook<Levels, MatchingPolicy>::getTotalOrders() const {
     // Read operation - acquire shared lock
     std::shared_lock<std::shared_mutex> lock(bookMutex);
-    
-    size_t total = 0;
-    for (const auto& [price, orders] : buyBook) {
-        total += orders.size();
-    }
-    for (const auto& [price, orders] : sellBook) {
-        total += orders.size();
-    }
-    
-    return total;
+    return buyTotals.orders + sellTotals.orders;
 }
 
-bool OrderBook::isEmpty() const {
+template<template<typename> class Levels, typename MatchingPolicy>
+bool BasicOrderBook<Levels, MatchingPolicy>::isEmpty() const {
     // Read operation - acquire shared lock
     std::shared_lock<std::shared_mutex> lock(bookMutex);
     return buyBook.empty() && sellBook.empty();
 }
 
-size_t OrderBook::getTradeCount() const {
+template<template<typename> class Levels, typename MatchingPolicy>
+size_t BasicOrderBook<Levels, MatchingPolicy>::getTradeCount() const {
     // Read operation - acquire shared lock
     std::shared_lock<std::shared_mutex> lock(bookMutex);
-    return tradeLog.size();
+    return tradeLog.totalCount();
 }
 
+template class BasicOrderBook<MapPriceLevels, FifoMatching>;
+template class BasicOrderBook<MapPriceLevels, ProRataMatching>;
+template class BasicOrderBook<MapPriceLevels, TopOrderProRataMatching>;
+template class BasicOrderBook<LadderPriceLevels, FifoMatching>;
+template class BasicOrderBook<LadderPriceLevels, ProRataMatching>;
+template class BasicOrderBook<LadderPriceLevels, TopOrderProRataMatching>;
+
 } // namespace velocore
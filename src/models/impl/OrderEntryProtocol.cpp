@@ -0,0 +1,219 @@
+#include "OrderEntryProtocol.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace velocore {
+
+namespace {
+
+// Byte-wise so the wire format is little-endian whatever the host is; compilers fold these into plain loads and stores
+
+void put8(uint8_t* out, size_t offset, uint8_t value) {
+    out[offset] = value;
+}
+
+void put32(uint8_t* out, size_t offset, uint32_t value) {
+    for (size_t i = 0; i < 4; ++i) {
+        out[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void put64(uint8_t* out, size_t offset, uint64_t value) {
+    for (size_t i = 0; i < 8; ++i) {
+        out[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint16_t get16(const uint8_t* in, size_t offset) {
+    return static_cast<uint16_t>(in[offset] | (in[offset + 1] << 8));
+}
+
+uint32_t get32(const uint8_t* in, size_t offset) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(in[offset + i]) << (8 * i);
+    }
+    return value;
+}
+
+uint64_t get64(const uint8_t* in, size_t offset) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(in[offset + i]) << (8 * i);
+    }
+    return value;
+}
+
+// Zeroes the message, then writes its header
+void putHeader(uint8_t* out, OrderEntryMessageType type, size_t size) {
+    std::memset(out, 0, size);
+    out[0] = static_cast<uint8_t>(size);
+    out[1] = static_cast<uint8_t>(size >> 8);
+    out[2] = static_cast<uint8_t>(type);
+}
+
+bool isRequest(uint8_t type) {
+    return type == static_cast<uint8_t>(OrderEntryMessageType::NewOrder) ||
+           type == static_cast<uint8_t>(OrderEntryMessageType::Cancel) ||
+           type == static_cast<uint8_t>(OrderEntryMessageType::Amend);
+}
+
+} // namespace
+
+size_t order_entry_message_size(uint8_t type) {
+    switch (static_cast<OrderEntryMessageType>(type)) {
+        case OrderEntryMessageType::NewOrder: return NewOrderMessage::SIZE;
+        case OrderEntryMessageType::Cancel: return CancelMessage::SIZE;
+        case OrderEntryMessageType::Amend: return AmendMessage::SIZE;
+        case OrderEntryMessageType::Ack: return AckMessage::SIZE;
+        case OrderEntryMessageType::Fill: return FillMessage::SIZE;
+        case OrderEntryMessageType::Reject: return RejectMessage::SIZE;
+    }
+    return 0;
+}
+
+bool decode_header(const uint8_t* in, OrderEntryHeader& header) {
+    size_t expected = order_entry_message_size(in[2]);
+    header.length = get16(in, 0);
+    header.type = static_cast<OrderEntryMessageType>(in[2]);
+    return expected != 0 && header.length == expected;
+}
+
+size_t encode(const NewOrderMessage& message, uint8_t* out) {
+    if (message.symbol.empty() || message.symbol.size() > ORDER_ENTRY_SYMBOL_SIZE) {
+        throw std::invalid_argument("Symbol must be 1 to 8 characters");
+    }
+    putHeader(out, OrderEntryMessageType::NewOrder, NewOrderMessage::SIZE);
+    put64(out, 4, message.client_order_id);
+    std::memcpy(out + 12, message.symbol.data(), message.symbol.size());
+    put8(out, 20, message.side == Side::Buy ? 0 : 1);
+    put8(out, 21, message.type == OrderType::Limit ? 0 : 1);
+    put32(out, 24, message.quantity);
+    put64(out, 28, static_cast<uint64_t>(message.price.ticks));
+    return NewOrderMessage::SIZE;
+}
+
+size_t encode(const CancelMessage& message, uint8_t* out) {
+    putHeader(out, OrderEntryMessageType::Cancel, CancelMessage::SIZE);
+    put64(out, 4, message.client_order_id);
+    put64(out, 12, message.order_id);
+    return CancelMessage::SIZE;
+}
+
+size_t encode(const AmendMessage& message, uint8_t* out) {
+    putHeader(out, OrderEntryMessageType::Amend, AmendMessage::SIZE);
+    put64(out, 4, message.client_order_id);
+    put64(out, 12, message.order_id);
+    put32(out, 20, message.quantity);
+    put64(out, 24, static_cast<uint64_t>(message.price.ticks));
+    return AmendMessage::SIZE;
+}
+
+size_t encode(const AckMessage& message, uint8_t* out) {
+    putHeader(out, OrderEntryMessageType::Ack, AckMessage::SIZE);
+    put64(out, 4, message.client_order_id);
+    put64(out, 12, message.order_id);
+    put8(out, 20, static_cast<uint8_t>(message.request));
+    put32(out, 24, message.leaves_quantity);
+    put32(out, 28, message.executed_quantity);
+    return AckMessage::SIZE;
+}
+
+size_t encode(const FillMessage& message, uint8_t* out) {
+    putHeader(out, OrderEntryMessageType::Fill, FillMessage::SIZE);
+    put64(out, 4, message.client_order_id);
+    put64(out, 12, message.order_id);
+    put64(out, 20, message.trade_id);
+    put64(out, 28, static_cast<uint64_t>(message.price.ticks));
+    put32(out, 36, message.quantity);
+    put8(out, 40, static_cast<uint8_t>(message.liquidity));
+    return FillMessage::SIZE;
+}
+
+size_t encode(const RejectMessage& message, uint8_t* out) {
+    putHeader(out, OrderEntryMessageType::Reject, RejectMessage::SIZE);
+    put64(out, 4, message.client_order_id);
+    put64(out, 12, message.order_id);
+    put8(out, 20, static_cast<uint8_t>(message.request));
+    put8(out, 21, static_cast<uint8_t>(message.reason));
+    return RejectMessage::SIZE;
+}
+
+bool decode(const uint8_t* in, NewOrderMessage& message) {
+    if (in[20] > 1 || in[21] > 1) {
+        return false;
+    }
+    message.client_order_id = get64(in, 4);
+    const char* symbol = reinterpret_cast<const char*>(in + 12);
+    message.symbol.assign(symbol, strnlen(symbol, ORDER_ENTRY_SYMBOL_SIZE));
+    message.side = in[20] == 0 ? Side::Buy : Side::Sell;
+    message.type = in[21] == 0 ? OrderType::Limit : OrderType::Market;
+    message.quantity = get32(in, 24);
+    message.price = Price(static_cast<int64_t>(get64(in, 28)));
+    return true;
+}
+
+bool decode(const uint8_t* in, CancelMessage& message) {
+    message.client_order_id = get64(in, 4);
+    message.order_id = get64(in, 12);
+    return true;
+}
+
+bool decode(const uint8_t* in, AmendMessage& message) {
+    message.client_order_id = get64(in, 4);
+    message.order_id = get64(in, 12);
+    message.quantity = get32(in, 20);
+    message.price = Price(static_cast<int64_t>(get64(in, 24)));
+    return true;
+}
+
+bool decode(const uint8_t* in, AckMessage& message) {
+    if (!isRequest(in[20])) {
+        return false;
+    }
+    message.client_order_id = get64(in, 4);
+    message.order_id = get64(in, 12);
+    message.request = static_cast<OrderEntryMessageType>(in[20]);
+    message.leaves_quantity = get32(in, 24);
+    message.executed_quantity = get32(in, 28);
+    return true;
+}
+
+bool decode(const uint8_t* in, FillMessage& message) {
+    if (in[40] != static_cast<uint8_t>(Liquidity::Added) && in[40] != static_cast<uint8_t>(Liquidity::Removed)) {
+        return false;
+    }
+    message.client_order_id = get64(in, 4);
+    message.order_id = get64(in, 12);
+    message.trade_id = get64(in, 20);
+    message.price = Price(static_cast<int64_t>(get64(in, 28)));
+    message.quantity = get32(in, 36);
+    message.liquidity = static_cast<Liquidity>(in[40]);
+    return true;
+}
+
+bool decode(const uint8_t* in, RejectMessage& message) {
+    if (!isRequest(in[20]) || in[21] < static_cast<uint8_t>(RejectReason::InvalidMessage) ||
+        in[21] > static_cast<uint8_t>(RejectReason::InvalidAmend)) {
+        return false;
+    }
+    message.client_order_id = get64(in, 4);
+    message.order_id = get64(in, 12);
+    message.request = static_cast<OrderEntryMessageType>(in[20]);
+    message.reason = static_cast<RejectReason>(in[21]);
+    return true;
+}
+
+const char* to_string(RejectReason reason) {
+    switch (reason) {
+        case RejectReason::InvalidMessage: return "Invalid message";
+        case RejectReason::InvalidSymbol: return "Invalid symbol";
+        case RejectReason::InvalidQuantity: return "Invalid quantity";
+        case RejectReason::InvalidPrice: return "Invalid price";
+        case RejectReason::UnknownOrder: return "Unknown order";
+        case RejectReason::InvalidAmend: return "Invalid amend";
+    }
+    return "Unknown";
+}
+
+} // namespace velocore
@@ -0,0 +1,148 @@
+#include "OrderPool.h"
+#include <algorithm>
+
+namespace velocore {
+
+OrderPool::OrderPool(size_t chunkSize)
+    : chunkSize(std::max<size_t>(chunkSize, 1))
+    , freeList(nullptr)
+    , nodesInUse(0) {
+    addChunk();
+}
+
+void OrderPool::addChunk() {
+    uint32_t firstSlot = static_cast<uint32_t>(chunks.size() * chunkSize);
+    chunks.push_back(Chunk{std::make_unique<OrderNode[]>(chunkSize), std::make_unique<Order[]>(chunkSize)});
+    OrderNode* chunk = chunks.back().nodes.get();
+
+    // Thread the new nodes onto the front of the free list
+    for (size_t i = 0; i < chunkSize; ++i) {
+        chunk[i].slot = firstSlot + static_cast<uint32_t>(i);
+        chunk[i].prev = nullptr;
+        chunk[i].next = freeList;
+        freeList = &chunk[i];
+    }
+}
+
+OrderNode* OrderPool::acquire(const Order& order) {
+    if (!freeList) {
+        addChunk();
+    }
+
+    OrderNode* node = freeList;
+    freeList = node->next;
+
+    node->id = order.id;
+    node->remaining_quantity = order.remaining_quantity;
+    details(node) = order;
+    node->prev = nullptr;
+    node->next = nullptr;
+    nodesInUse++;
+    return node;
+}
+
+void OrderPool::release(OrderNode* node) {
+    node->prev = nullptr;
+    node->next = freeList;
+    freeList = node;
+    nodesInUse--;
+}
+
+void OrderPool::releaseAll() {
+    freeList = nullptr;
+    for (auto& chunk : chunks) {
+        for (size_t i = 0; i < chunkSize; ++i) {
+            chunk.nodes[i].prev = nullptr;
+            chunk.nodes[i].next = freeList;
+            freeList = &chunk.nodes[i];
+        }
+    }
+    nodesInUse = 0;
+}
+
+OrderIndex::OrderIndex(size_t capacity) : count(0) {
+    size_t rounded = 16;
+    while (rounded < capacity) rounded *= 2;
+    slots.resize(rounded);
+    mask = rounded - 1;
+}
+
+size_t OrderIndex::slotFor(uint64_t id) const {
+    // Order ids are sequential, mix them so neighbours spread across the table
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdULL;
+    id ^= id >> 33;
+    return static_cast<size_t>(id) & mask;
+}
+
+OrderNode* OrderIndex::find(uint64_t id) const {
+    for (size_t i = slotFor(id); slots[i].node; i = (i + 1) & mask) {
+        if (slots[i].id == id) {
+            return slots[i].node;
+        }
+    }
+    return nullptr;
+}
+
+void OrderIndex::insert(uint64_t id, OrderNode* node) {
+    if ((count + 1) * 2 > slots.size()) {
+        grow();
+    }
+
+    size_t i = slotFor(id);
+    while (slots[i].node && slots[i].id != id) {
+        i = (i + 1) & mask;
+    }
+
+    if (!slots[i].node) {
+        count++;
+    }
+    slots[i].id = id;
+    slots[i].node = node;
+}
+
+bool OrderIndex::erase(uint64_t id) {
+    size_t i = slotFor(id);
+    while (slots[i].node && slots[i].id != id) {
+        i = (i + 1) & mask;
+    }
+    if (!slots[i].node) {
+        return false;
+    }
+
+    // Backward-shift deletion: pull later entries of the probe run into the
+    // hole so lookups never need tombstones
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask; slots[j].node; j = (j + 1) & mask) {
+        size_t home = slotFor(slots[j].id);
+        // Move the entry back only if its home slot is not between hole and j
+        bool canMove = (hole <= j) ? (home <= hole || home > j) : (home <= hole && home > j);
+        if (canMove) {
+            slots[hole] = slots[j];
+            hole = j;
+        }
+    }
+    slots[hole] = Slot{};
+    count--;
+    return true;
+}
+
+void OrderIndex::clear() {
+    std::fill(slots.begin(), slots.end(), Slot{});
+    count = 0;
+}
+
+void OrderIndex::grow() {
+    std::vector<Slot> old = std::move(slots);
+    slots.assign(old.size() * 2, Slot{});
+    mask = slots.size() - 1;
+    count = 0;
+
+    for (const auto& slot : old) {
+        if (slot.node) {
+            insert(slot.id, slot.node);
+        }
+    }
+}
+
+} // namespace velocore
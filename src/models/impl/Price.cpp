@@ -0,0 +1,64 @@
+#include "Price.h"
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace velocore {
+
+namespace {
+
+// Symbols with small ids are read without a lock, since every trade's price
+// is rendered through here; 0 means no tick size was set
+constexpr size_t DIRECT_TICK_SIZES = 4096;
+std::atomic<double> directTickSizes[DIRECT_TICK_SIZES];
+
+// Any further symbols
+std::shared_mutex tickSizeMutex;
+std::unordered_map<SymbolId, double> tickSizes;
+
+} // namespace
+
+Price Price::from_double(double value, double tick_size) {
+    if (tick_size <= 0.0) {
+        throw std::invalid_argument("Tick size must be greater than 0");
+    }
+    return Price(std::llround(value / tick_size));
+}
+
+double Price::to_double(double tick_size) const {
+    return static_cast<double>(ticks) * tick_size;
+}
+
+double tick_size_for(SymbolId symbol) {
+    if (symbol.value < DIRECT_TICK_SIZES) {
+        double tickSize = directTickSizes[symbol.value].load(std::memory_order_relaxed);
+        return tickSize > 0.0 ? tickSize : DEFAULT_TICK_SIZE;
+    }
+    
+    std::shared_lock<std::shared_mutex> lock(tickSizeMutex);
+    auto it = tickSizes.find(symbol);
+    return it == tickSizes.end() ? DEFAULT_TICK_SIZE : it->second;
+}
+
+double tick_size_for(const std::string& symbol) {
+    return tick_size_for(find_symbol(symbol));
+}
+
+void set_tick_size(const std::string& symbol, double tick_size) {
+    if (tick_size <= 0.0) {
+        throw std::invalid_argument("Tick size must be greater than 0");
+    }
+    SymbolId id = intern_symbol(symbol);
+    if (id.value < DIRECT_TICK_SIZES) {
+        directTickSizes[id.value].store(tick_size, std::memory_order_relaxed);
+        return;
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(tickSizeMutex);
+    tickSizes[id] = tick_size;
+}
+
+} // namespace velocore
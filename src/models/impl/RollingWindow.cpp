@@ -0,0 +1,156 @@
+#include "RollingWindow.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace velocore {
+
+double WindowSummary::trades_per_second() const {
+    double seconds = std::chrono::duration<double>(covered).count();
+    return seconds > 0.0 ? static_cast<double>(trades) / seconds : 0.0;
+}
+
+crow::json::wvalue WindowSummary::to_json(double tickSize) const {
+    return crow::json::wvalue{
+        {"window_seconds", std::chrono::duration<double>(length).count()},
+        {"covered_seconds", std::chrono::duration<double>(covered).count()},
+        {"trades", static_cast<int64_t>(trades)},
+        {"volume", volume},
+        {"vwap", vwap_ticks * tickSize},
+        {"open", open.to_double(tickSize)},
+        {"high", high.to_double(tickSize)},
+        {"low", low.to_double(tickSize)},
+        {"close", close.to_double(tickSize)},
+        {"trades_per_second", trades_per_second()}
+    };
+}
+
+RollingWindow::RollingWindow(std::chrono::nanoseconds length)
+    : bucketWidth(length / static_cast<int64_t>(BUCKET_COUNT)) {
+    if (bucketWidth.count() <= 0) {
+        throw std::invalid_argument("Window length must be positive");
+    }
+}
+
+int64_t RollingWindow::bucketIndex(std::chrono::steady_clock::time_point time) const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()) / bucketWidth;
+}
+
+void RollingWindow::add(const Trade& trade) {
+    int64_t index = bucketIndex(trade.timestamp);
+    Bucket& bucket = buckets[static_cast<size_t>(index) % BUCKET_COUNT];
+
+    if (bucket.index != index) {
+        // The slot already holds a newer bucket, so this trade has left the window
+        if (bucket.index > index) {
+            return;
+        }
+
+        // Recycle a bucket the window has moved past
+        bucket = Bucket{};
+        bucket.index = index;
+        bucket.open = trade.price;
+        bucket.high = trade.price;
+        bucket.low = trade.price;
+    }
+    if (firstIndex < 0 || index < firstIndex) {
+        firstIndex = index;
+    }
+
+    bucket.trades++;
+    bucket.volume += trade.quantity;
+    bucket.notional += trade.price.ticks * trade.quantity;
+    bucket.high = std::max(bucket.high, trade.price);
+    bucket.low = std::min(bucket.low, trade.price);
+    bucket.close = trade.price;
+}
+
+WindowSummary RollingWindow::summary(std::chrono::steady_clock::time_point now) const {
+    WindowSummary result;
+    result.length = length();
+
+    int64_t newest = bucketIndex(now);
+    int64_t oldest = newest - static_cast<int64_t>(BUCKET_COUNT) + 1;
+    int64_t openIndex = 0;
+    int64_t closeIndex = 0;
+    int64_t notional = 0;
+
+    for (const Bucket& bucket : buckets) {
+        if (bucket.index < oldest || bucket.index > newest) {
+            continue;
+        }
+
+        if (result.trades == 0) {
+            result.high = bucket.high;
+            result.low = bucket.low;
+            result.open = bucket.open;
+            result.close = bucket.close;
+            openIndex = bucket.index;
+            closeIndex = bucket.index;
+        } else {
+            result.high = std::max(result.high, bucket.high);
+            result.low = std::min(result.low, bucket.low);
+            if (bucket.index < openIndex) {
+                result.open = bucket.open;
+                openIndex = bucket.index;
+            }
+            if (bucket.index > closeIndex) {
+                result.close = bucket.close;
+                closeIndex = bucket.index;
+            }
+        }
+
+        result.trades += bucket.trades;
+        result.volume += bucket.volume;
+        notional += bucket.notional;
+    }
+
+    // Measured from the start of the oldest bucket holding history, which is younger
+    // than the window itself until trades have been arriving for a full length
+    if (firstIndex >= 0) {
+        std::chrono::nanoseconds historyStart = bucketWidth * std::max(firstIndex, oldest);
+        std::chrono::nanoseconds covered = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            now.time_since_epoch()) - historyStart;
+        result.covered = std::min(std::max(covered, bucketWidth), result.length);
+    }
+
+    if (result.volume > 0) {
+        result.vwap_ticks = static_cast<double>(notional) / static_cast<double>(result.volume);
+    }
+    return result;
+}
+
+void RollingWindow::clear() {
+    buckets.fill(Bucket{});
+    firstIndex = -1;
+}
+
+TradeAnalytics::TradeAnalytics()
+    : windows{RollingWindow(std::chrono::seconds(1)),
+              RollingWindow(std::chrono::minutes(1)),
+              RollingWindow(std::chrono::minutes(5))} {}
+
+void TradeAnalytics::add(const Trade& trade) {
+    for (RollingWindow& window : windows) {
+        window.add(trade);
+    }
+}
+
+WindowSummary TradeAnalytics::summary(size_t window, std::chrono::steady_clock::time_point now) const {
+    return windows.at(window).summary(now);
+}
+
+crow::json::wvalue TradeAnalytics::to_json(double tickSize, std::chrono::steady_clock::time_point now) const {
+    return crow::json::wvalue{
+        {"1s", windows[0].summary(now).to_json(tickSize)},
+        {"1m", windows[1].summary(now).to_json(tickSize)},
+        {"5m", windows[2].summary(now).to_json(tickSize)}
+    };
+}
+
+void TradeAnalytics::clear() {
+    for (RollingWindow& window : windows) {
+        window.clear();
+    }
+}
+
+} // namespace velocore
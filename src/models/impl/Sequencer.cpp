@@ -0,0 +1,178 @@
+#include "Sequencer.h"
+#include <chrono>
+#include <stdexcept>
+#include <type_traits>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace velocore {
+
+namespace {
+
+// Idle polls before the matching thread starts yielding, then sleeping
+constexpr int SPIN_POLLS = 1000;
+constexpr int YIELD_POLLS = 100;
+constexpr auto IDLE_SLEEP = std::chrono::microseconds(50);
+
+} // namespace
+
+Sequencer::Sequencer(Exchange& exchange, size_t queueCapacity)
+    : exchange(exchange)
+    , queue(queueCapacity) {}
+
+Sequencer::~Sequencer() {
+    stop();
+}
+
+void Sequencer::start(int cpu) {
+    if (running.exchange(true)) {
+        return;
+    }
+
+    matchingThread = std::thread([this]() { run(); });
+    if (cpu >= 0) {
+        pinToCpu(matchingThread, cpu);
+    }
+}
+
+void Sequencer::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    if (matchingThread.joinable()) {
+        matchingThread.join();
+    }
+}
+
+std::future<std::vector<Trade>> Sequencer::submitOrder(const Order& order) {
+    NewOrderCommand command{order, {}};
+    std::future<std::vector<Trade>> result = command.result.get_future();
+    push(Command(std::move(command)));
+    return result;
+}
+
+std::future<std::vector<std::vector<Trade>>> Sequencer::submitOrders(std::vector<Order> orders) {
+    BatchCommand command{std::move(orders), {}};
+    std::future<std::vector<std::vector<Trade>>> result = command.result.get_future();
+    push(Command(std::move(command)));
+    return result;
+}
+
+std::future<std::optional<std::vector<Trade>>> Sequencer::submitAmend(SymbolId symbol, uint64_t orderId,
+                                                                      Price newPrice, int newQuantity) {
+    AmendCommand command{symbol, orderId, newPrice, newQuantity, {}};
+    std::future<std::optional<std::vector<Trade>>> result = command.result.get_future();
+    push(Command(std::move(command)));
+    return result;
+}
+
+std::future<bool> Sequencer::submitCancel(uint64_t orderId, SymbolId symbol) {
+    CancelCommand command{orderId, symbol, {}};
+    std::future<bool> result = command.result.get_future();
+    push(Command(std::move(command)));
+    return result;
+}
+
+void Sequencer::push(Command&& command) {
+    // Counted before running is read, so the matching thread cannot exit between the check and the push
+    pushing.fetch_add(1);
+    if (!running.load()) {
+        pushing.fetch_sub(1);
+        std::visit([](auto& rejected) {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(rejected)>, std::monostate>) {
+                rejected.result.set_exception(std::make_exception_ptr(std::runtime_error("Sequencer is not running")));
+            }
+        }, command);
+        return;
+    }
+
+    while (!queue.tryPush(std::move(command))) {
+        // Queue full - let the matching thread catch up
+        std::this_thread::yield();
+    }
+    pushing.fetch_sub(1);
+}
+
+void Sequencer::run() {
+    Command command;
+    int idlePolls = 0;
+
+    // Keep draining after stop() so no queued caller is left waiting
+    while (true) {
+        if (queue.tryPop(command)) {
+            execute(command);
+            processed.fetch_add(1, std::memory_order_relaxed);
+            idlePolls = 0;
+            continue;
+        }
+
+        // Once stopped with nobody mid-push, nothing more can arrive behind the last pop
+        if (!running.load() && pushing.load() == 0) {
+            while (queue.tryPop(command)) {
+                execute(command);
+                processed.fetch_add(1, std::memory_order_relaxed);
+            }
+            break;
+        }
+
+        if (++idlePolls < SPIN_POLLS) {
+            continue;
+        } else if (idlePolls < SPIN_POLLS + YIELD_POLLS) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(IDLE_SLEEP);
+        }
+    }
+}
+
+void Sequencer::execute(Command& command) {
+    if (auto* newOrder = std::get_if<NewOrderCommand>(&command)) {
+        try {
+            newOrder->result.set_value(exchange.addOrder(newOrder->order));
+        } catch (...) {
+            newOrder->result.set_exception(std::current_exception());
+        }
+    } else if (auto* batch = std::get_if<BatchCommand>(&command)) {
+        try {
+            batch->result.set_value(exchange.addOrders(batch->orders));
+        } catch (...) {
+            batch->result.set_exception(std::current_exception());
+        }
+    } else if (auto* amend = std::get_if<AmendCommand>(&command)) {
+        try {
+            amend->result.set_value(exchange.amendOrder(amend->symbol, amend->orderId,
+                                                        amend->newPrice, amend->newQuantity));
+        } catch (...) {
+            amend->result.set_exception(std::current_exception());
+        }
+    } else if (auto* cancel = std::get_if<CancelCommand>(&command)) {
+        try {
+            bool cancelled = cancel->symbol.empty()
+                ? exchange.cancelOrder(cancel->orderId)
+                : exchange.cancelOrder(cancel->symbol, cancel->orderId);
+            cancel->result.set_value(cancelled);
+        } catch (...) {
+            cancel->result.set_exception(std::current_exception());
+        }
+    }
+
+    command = std::monostate{};
+}
+
+void Sequencer::pinToCpu(std::thread& thread, int cpu) {
+#ifdef __linux__
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset);
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+}
+
+} // namespace velocore
@@ -0,0 +1,85 @@
+#include "ShardedTradeStatistics.h"
+#include <algorithm>
+#include <chrono>
+
+namespace velocore {
+
+namespace {
+
+// Hands threads their shards round-robin
+std::atomic<size_t> nextShard{0};
+
+void atomicAdd(std::atomic<double>& target, double delta) {
+    double current = target.load(std::memory_order_relaxed);
+    while (!target.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {}
+}
+
+template<typename T>
+void atomicMin(std::atomic<T>& target, T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+template<typename T>
+void atomicMax(std::atomic<T>& target, T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+} // namespace
+
+size_t ShardedTradeStatistics::shardIndex() {
+    thread_local size_t index = nextShard.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+    return index;
+}
+
+void ShardedTradeStatistics::update(const Trade& trade) {
+    // Usually the only writer to its shard, so the compare-exchanges succeed first time
+    Shard& shard = shards[shardIndex()];
+    double price = trade.price_value();
+    
+    shard.volume.fetch_add(static_cast<uint64_t>(trade.quantity), std::memory_order_relaxed);
+    atomicAdd(shard.value, price * trade.quantity);
+    atomicMin(shard.minPrice, price);
+    atomicMax(shard.maxPrice, price);
+    atomicMax(shard.lastTradeNanos, static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(trade.timestamp.time_since_epoch()).count()));
+    
+    // Published last, so a reader that sees the count also sees every field of the trades it covers
+    shard.trades.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t ShardedTradeStatistics::tradeCount() const {
+    uint64_t trades = 0;
+    for (const Shard& shard : shards) {
+        trades += shard.trades.load(std::memory_order_acquire);
+    }
+    return trades;
+}
+
+TradeStatistics ShardedTradeStatistics::snapshot() const {
+    uint64_t trades = 0;
+    uint64_t volume = 0;
+    int64_t lastTradeNanos = 0;
+    TradeStatistics merged;
+    
+    for (const Shard& shard : shards) {
+        trades += shard.trades.load(std::memory_order_acquire);
+        volume += shard.volume.load(std::memory_order_relaxed);
+        merged.total_value += shard.value.load(std::memory_order_relaxed);
+        merged.min_price = std::min(merged.min_price, shard.minPrice.load(std::memory_order_relaxed));
+        merged.max_price = std::max(merged.max_price, shard.maxPrice.load(std::memory_order_relaxed));
+        lastTradeNanos = std::max(lastTradeNanos, shard.lastTradeNanos.load(std::memory_order_relaxed));
+    }
+    
+    merged.total_trades = static_cast<int>(trades);
+    merged.total_volume = static_cast<int>(volume);
+    merged.avg_price = volume > 0 ? merged.total_value / static_cast<double>(volume) : 0.0;
+    if (lastTradeNanos != 0) {
+        merged.last_trade_time = std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(lastTradeNanos)));
+    }
+    return merged;
+}
+
+} // namespace velocore
@@ -0,0 +1,58 @@
+#include "SnapshotCache.h"
+#include "Clock.h"
+#include <mutex>
+
+namespace velocore {
+
+SnapshotCache::SnapshotCache()
+    : instanceTag(static_cast<uint64_t>(Clock::toUnixMillis(Clock::now()))) {}
+
+std::shared_ptr<const CachedSnapshot> SnapshotCache::find(SnapshotKey key, SnapshotVersion version) const {
+    // Read operation - acquire shared lock
+    std::shared_lock<std::shared_mutex> lock(entriesMutex);
+    auto it = entries.find(key);
+    if (it == entries.end() || !(it->second->version == version)) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+std::shared_ptr<const CachedSnapshot> SnapshotCache::store(SnapshotKey key, SnapshotVersion version, std::string body) {
+    auto entry = std::make_shared<CachedSnapshot>();
+    entry->version = version;
+    entry->body = std::move(body);
+    entry->etag = "\"" + std::to_string(instanceTag) + "-" + std::to_string(key.symbol.value) + "-" +
+                  std::to_string(key.view) + "-" + std::to_string(version.book) + "-" +
+                  std::to_string(version.trades) + "\"";
+
+    // Write operation - acquire exclusive lock
+    std::unique_lock<std::shared_mutex> lock(entriesMutex);
+    entries[key] = entry;
+    return entry;
+}
+
+bool SnapshotCache::matches(std::string_view ifNoneMatch, std::string_view etag) {
+    // Comma-separated list of ETags, each possibly weak (W/"...")
+    size_t position = 0;
+    while (position < ifNoneMatch.size()) {
+        size_t end = ifNoneMatch.find(',', position);
+        if (end == std::string_view::npos) {
+            end = ifNoneMatch.size();
+        }
+
+        std::string_view candidate = ifNoneMatch.substr(position, end - position);
+        while (!candidate.empty() && candidate.front() == ' ') candidate.remove_prefix(1);
+        while (!candidate.empty() && candidate.back() == ' ') candidate.remove_suffix(1);
+        if (candidate.substr(0, 2) == "W/") {
+            candidate.remove_prefix(2);
+        }
+
+        if (candidate == "*" || candidate == etag) {
+            return true;
+        }
+        position = end + 1;
+    }
+    return false;
+}
+
+} // namespace velocore
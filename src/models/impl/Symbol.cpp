@@ -0,0 +1,52 @@
+#include "Symbol.h"
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace velocore {
+
+namespace {
+
+std::shared_mutex symbolMutex;
+std::unordered_map<std::string, SymbolId> symbolIds;
+
+// Indexed by id; a deque so references handed out by symbol_name stay valid
+std::deque<std::string> symbolNames(1);
+
+} // namespace
+
+SymbolId intern_symbol(const std::string& symbol) {
+    if (symbol.empty()) {
+        return SymbolId();
+    }
+
+    {
+        // Fast path - the ticker is already interned
+        std::shared_lock<std::shared_mutex> lock(symbolMutex);
+        auto it = symbolIds.find(symbol);
+        if (it != symbolIds.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(symbolMutex);
+    auto [it, inserted] = symbolIds.try_emplace(symbol, static_cast<uint32_t>(symbolNames.size()));
+    if (inserted) {
+        symbolNames.push_back(symbol);
+    }
+    return it->second;
+}
+
+SymbolId find_symbol(const std::string& symbol) {
+    std::shared_lock<std::shared_mutex> lock(symbolMutex);
+    auto it = symbolIds.find(symbol);
+    return it == symbolIds.end() ? SymbolId() : it->second;
+}
+
+const std::string& symbol_name(SymbolId id) {
+    std::shared_lock<std::shared_mutex> lock(symbolMutex);
+    return id.value < symbolNames.size() ? symbolNames[id.value] : symbolNames.front();
+}
+
+} // namespace velocore
@@ -1,19 +1,30 @@
 #include "Trade.h"
+#include "Clock.h"
 #include <limits>
 
 namespace velocore {
 
 std::atomic<uint64_t> Trade::id_counter{1};
 
-Trade::Trade(uint64_t buy_order_id, uint64_t sell_order_id, const std::string& symbol, 
-             double price, int quantity)
+Trade::Trade(uint64_t buy_order_id, uint64_t sell_order_id, SymbolId symbol, 
+             Price price, int quantity)
     : trade_id(generate_id())
     , buy_order_id(buy_order_id)
     , sell_order_id(sell_order_id)
     , symbol(symbol)
     , price(price)
     , quantity(quantity)
-    , timestamp(std::chrono::steady_clock::now()) {}
+    , timestamp(Clock::now()) {}
+
+Trade::Trade(uint64_t trade_id, uint64_t buy_order_id, uint64_t sell_order_id, SymbolId symbol,
+             Price price, int quantity)
+    : trade_id(trade_id)
+    , buy_order_id(buy_order_id)
+    , sell_order_id(sell_order_id)
+    , symbol(symbol)
+    , price(price)
+    , quantity(quantity)
+    , timestamp(Clock::now()) {}
 
 TradeStatistics::TradeStatistics() 
     : total_trades(0)
@@ -27,40 +38,59 @@ uint64_t Trade::generate_id() {
     return id_counter.fetch_add(1);
 }
 
+double Trade::price_value() const {
+    return price.to_double(tick_size_for(symbol));
+}
+
 double Trade::total_value() const {
-    return price * quantity;
+    return price_value() * quantity;
 }
 
 crow::json::wvalue Trade::to_json() const {
-    auto duration = timestamp.time_since_epoch();
-    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-    
     return crow::json::wvalue{
         {"trade_id", static_cast<int64_t>(trade_id)},
         {"buy_order_id", static_cast<int64_t>(buy_order_id)},
         {"sell_order_id", static_cast<int64_t>(sell_order_id)},
-        {"symbol", symbol},
-        {"price", price},
+        {"symbol", symbol_name(symbol)},
+        {"price", price_value()},
         {"quantity", quantity},
         {"total_value", total_value()},
-        {"timestamp", millis}
+        {"timestamp", Clock::toUnixMillis(timestamp)}
     };
 }
 
+void Trade::write_json(JsonWriter& writer) const {
+    double tickSize = tick_size_for(symbol);
+    double priceValue = price.to_double(tickSize);
+    writer.beginObject()
+        .field("trade_id", trade_id)
+        .field("buy_order_id", buy_order_id)
+        .field("sell_order_id", sell_order_id)
+        .field("symbol", symbol_name(symbol))
+        .field("price", priceValue)
+        .field("quantity", quantity)
+        .field("total_value", priceValue * quantity)
+        .field("timestamp", Clock::toUnixMillis(timestamp))
+        .endObject();
+}
+
 Trade Trade::from_json(const crow::json::rvalue& json) {
     Trade trade;
     trade.trade_id = generate_id();
     trade.buy_order_id = json["buy_order_id"].u();
     trade.sell_order_id = json["sell_order_id"].u();
-    trade.symbol = json["symbol"].s();
-    trade.price = json["price"].d();
+    trade.symbol = intern_symbol(json["symbol"].s());
+    trade.price = Price::from_double(json["price"].d(), tick_size_for(trade.symbol));
     trade.quantity = json["quantity"].i();
-    trade.timestamp = std::chrono::steady_clock::now();
+    trade.timestamp = Clock::now();
     return trade;
 }
 
 bool operator<(const Trade& lhs, const Trade& rhs) {
-    return lhs.timestamp < rhs.timestamp;
+    if (lhs.timestamp != rhs.timestamp) {
+        return lhs.timestamp < rhs.timestamp;
+    }
+    return lhs.trade_id < rhs.trade_id;
 }
 
 void TradeStatistics::update(const Trade& trade) {
@@ -69,16 +99,14 @@ void TradeStatistics::update(const Trade& trade) {
     total_value += trade.total_value();
     avg_price = total_value / total_volume;
     
-    if (trade.price < min_price) min_price = trade.price;
-    if (trade.price > max_price) max_price = trade.price;
+    double price = trade.price_value();
+    if (price < min_price) min_price = price;
+    if (price > max_price) max_price = price;
     
     last_trade_time = trade.timestamp;
 }
 
 crow::json::wvalue TradeStatistics::to_json() const {
-    auto duration = last_trade_time.time_since_epoch();
-    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
-    
     return crow::json::wvalue{
         {"total_trades", total_trades},
         {"total_volume", total_volume},
@@ -86,8 +114,20 @@ crow::json::wvalue TradeStatistics::to_json() const {
         {"avg_price", avg_price},
         {"min_price", min_price == std::numeric_limits<double>::max() ? 0.0 : min_price},
         {"max_price", max_price == std::numeric_limits<double>::lowest() ? 0.0 : max_price},
-        {"last_trade_time", millis}
+        {"last_trade_time", Clock::toUnixMillis(last_trade_time)}
     };
 }
 
+void TradeStatistics::write_json(JsonWriter& writer) const {
+    writer.beginObject()
+        .field("total_trades", total_trades)
+        .field("total_volume", total_volume)
+        .field("total_value", total_value)
+        .field("avg_price", avg_price)
+        .field("min_price", min_price == std::numeric_limits<double>::max() ? 0.0 : min_price)
+        .field("max_price", max_price == std::numeric_limits<double>::lowest() ? 0.0 : max_price)
+        .field("last_trade_time", Clock::toUnixMillis(last_trade_time))
+        .endObject();
+}
+
 } 
\ No newline at end of file
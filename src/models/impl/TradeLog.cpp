@@ -0,0 +1,202 @@
+#include "TradeLog.h"
+#include "Clock.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace velocore {
+
+TradeLog::TradeLog(size_t capacity, const std::string& spillPath)
+    : ringCapacity(std::max<size_t>(capacity, 1))
+    , head(0)
+    , appended(0) {
+    // Reserved up front so appending never reallocates; pages are only touched as trades arrive
+    ring.reserve(ringCapacity);
+
+    if (!spillPath.empty()) {
+        spillFile.open(spillPath, std::ios::binary | std::ios::app);
+        if (!spillFile) {
+            throw std::runtime_error("Cannot open trade spill file: " + spillPath);
+        }
+        spillWorker = std::thread([this]() { runSpill(); });
+    }
+}
+
+TradeLog::~TradeLog() {
+    if (!spillWorker.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(spillMutex);
+        spillStopping = true;
+    }
+    spillCondition.notify_one();
+    spillWorker.join();
+}
+
+void TradeLog::append(const Trade& trade) {
+    appended++;
+
+    // Grow until the first lap is complete, then overwrite the oldest slot
+    if (ring.size() < ringCapacity) {
+        ring.push_back(trade);
+        return;
+    }
+
+    spill(ring[head]);
+    ring[head] = trade;
+    head = (head + 1) % ringCapacity;
+}
+
+size_t TradeLog::lowerBound(uint64_t tradeId) const {
+    if (ring.empty()) {
+        return 0;
+    }
+
+    uint64_t firstId = (*this)[0].trade_id;
+    uint64_t lastId = back().trade_id;
+    if (tradeId <= firstId) {
+        return 0;
+    }
+    if (tradeId > lastId) {
+        return size();
+    }
+
+    // Consecutive ids - the offset from the oldest trade is the position
+    if (lastId - firstId + 1 == size()) {
+        return static_cast<size_t>(tradeId - firstId);
+    }
+
+    size_t low = 0;
+    size_t high = size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if ((*this)[mid].trade_id < tradeId) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+size_t TradeLog::upperBound(const Trade& trade) const {
+    // Trades are appended in time order, so the ring is sorted by operator<
+    size_t low = 0;
+    size_t high = size();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (trade < (*this)[mid]) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    return low;
+}
+
+const Trade* TradeLog::find(uint64_t tradeId) const {
+    size_t position = lowerBound(tradeId);
+    if (position < size() && (*this)[position].trade_id == tradeId) {
+        return &(*this)[position];
+    }
+    return nullptr;
+}
+
+void TradeLog::clear() {
+    ring.clear();
+    head = 0;
+    appended = 0;
+}
+
+void TradeLog::spill(const Trade& trade) {
+    if (!spillWorker.joinable()) {
+        return;
+    }
+
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(spillMutex);
+        wasEmpty = pendingSpill.empty();
+        pendingSpill.push_back(trade);
+    }
+    // The writer only sleeps once it has emptied the queue, so one wakeup per batch is enough
+    if (wasEmpty) {
+        spillCondition.notify_one();
+    }
+}
+
+void TradeLog::runSpill() {
+    std::vector<Trade> batch;
+    std::vector<SpillRecord> records;
+    SymbolId cachedSymbol;
+    std::string cachedName = symbol_name(cachedSymbol);
+
+    std::unique_lock<std::mutex> lock(spillMutex);
+    while (true) {
+        spillCondition.wait(lock, [&]() { return spillStopping || !pendingSpill.empty(); });
+        if (pendingSpill.empty()) {
+            return;
+        }
+        // Swapping keeps both buffers' capacity, so steady state appends never allocate
+        batch.swap(pendingSpill);
+        lock.unlock();
+
+        records.assign(batch.size(), SpillRecord{});
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const Trade& trade = batch[i];
+            SpillRecord& record = records[i];
+            record.trade_id = trade.trade_id;
+            record.buy_order_id = trade.buy_order_id;
+            record.sell_order_id = trade.sell_order_id;
+            record.price_ticks = trade.price.ticks;
+            // Steady and TSC time points mean nothing outside this process, so files hold wall-clock time
+            if (trade.timestamp != Clock::time_point{}) {
+                record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    Clock::toSystem(trade.timestamp).time_since_epoch()).count();
+            }
+            record.quantity = trade.quantity;
+            // A book's trades all share one symbol, so the registry is rarely consulted
+            if (trade.symbol != cachedSymbol) {
+                cachedSymbol = trade.symbol;
+                cachedName = symbol_name(cachedSymbol);
+            }
+            std::strncpy(record.symbol, cachedName.c_str(), SYMBOL_BYTES - 1);
+        }
+        spillFile.write(reinterpret_cast<const char*>(records.data()),
+                        static_cast<std::streamsize>(records.size() * sizeof(SpillRecord)));
+        spillFile.flush();
+        batch.clear();
+
+        lock.lock();
+    }
+}
+
+std::vector<Trade> TradeLog::readSpillFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open trade spill file: " + path);
+    }
+
+    std::vector<Trade> trades;
+    SpillRecord record;
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        Trade trade;
+        trade.trade_id = record.trade_id;
+        trade.buy_order_id = record.buy_order_id;
+        trade.sell_order_id = record.sell_order_id;
+        trade.price = Price(record.price_ticks);
+        if (record.timestamp_ns != 0) {
+            trade.timestamp = Clock::fromSystem(std::chrono::system_clock::time_point(
+                std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::nanoseconds(record.timestamp_ns))));
+        }
+        trade.quantity = record.quantity;
+        const char* symbolEnd = std::find(record.symbol, record.symbol + SYMBOL_BYTES, '\0');
+        trade.symbol = intern_symbol(std::string(record.symbol, static_cast<size_t>(symbolEnd - record.symbol)));
+        trades.push_back(std::move(trade));
+    }
+    return trades;
+}
+
+} // namespace velocore
@@ -75,10 +75,9 @@ crow::json::wvalue to_json(MarketDataType type) {
 
 crow::json::wvalue MarketTick::to_json() const {
     crow::json::wvalue json;
-    json["symbol"] = symbol;
+    json["symbol"] = symbol_name(symbol);
     json["type"] = to_string(type);
-    json["timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-        timestamp.time_since_epoch()).count();
+    json["timestamp"] = Clock::toUnixMillis(timestamp);
     
     if (type == MarketDataType::Trade) {
         json["trade_price"] = trade_price;
@@ -99,4 +98,29 @@ crow::json::wvalue MarketTick::to_json() const {
     return json;
 }
 
+void MarketTick::write_json(JsonWriter& writer) const {
+    writer.beginObject()
+        .field("symbol", symbol_name(symbol))
+        .field("type", to_string(type))
+        .field("timestamp", Clock::toUnixMillis(timestamp));
+    
+    if (type == MarketDataType::Trade) {
+        writer.field("trade_price", trade_price)
+            .field("trade_size", trade_size);
+    } else if (type == MarketDataType::Quote) {
+        writer.field("bid_price", bid_price)
+            .field("ask_price", ask_price)
+            .field("bid_size", bid_size)
+            .field("ask_size", ask_size);
+    } else if (type == MarketDataType::Bar) {
+        writer.field("open", open)
+            .field("high", high)
+            .field("low", low)
+            .field("close", close)
+            .field("volume", volume);
+    }
+    
+    writer.endObject();
+}
+
 } 
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace velocore {
+
+/**
+ * Bit scans over 64-bit words, compiled to a single instruction by GCC,
+ * Clang and MSVC alike.
+ */
+
+/**
+ * Index of the least significant set bit
+ * @note Undefined if bits is 0
+ */
+inline unsigned lowest_set_bit(uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long position;
+    _BitScanForward64(&position, bits);
+    return static_cast<unsigned>(position);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+/**
+ * Index of the most significant set bit
+ * @note Undefined if bits is 0
+ */
+inline unsigned highest_set_bit(uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long position;
+    _BitScanReverse64(&position, bits);
+    return static_cast<unsigned>(position);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(bits));
+#endif
+}
+
+} // namespace velocore
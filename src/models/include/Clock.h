@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace velocore {
+
+/**
+ * Clock - Cheap monotonic timestamps for the order and trade paths.
+ *
+ * On x86-64 Linux, when the kernel itself trusts the TSC as its clock
+ * source (so it is invariant and synchronized across cores), now() reads
+ * the TSC and scales it with a ratio calibrated against steady_clock on
+ * first use. That costs a few nanoseconds and never enters the kernel or
+ * the vDSO. Everywhere else it falls back to steady_clock::now().
+ *
+ * Time points stay on the steady_clock timeline, so they compare and
+ * subtract like any other steady_clock value. They are converted to wall
+ * time only when serialized, see toUnixMillis().
+ */
+class Clock {
+public:
+    using time_point = std::chrono::steady_clock::time_point;
+
+    /**
+     * @note Thread-safe - the first call calibrates, which takes a few milliseconds
+     */
+    static time_point now();
+
+    /**
+     * Converts a timestamp to wall-clock time, using the offset between the
+     * two clocks measured at calibration
+     */
+    static std::chrono::system_clock::time_point toSystem(time_point time);
+
+    /**
+     * Converts wall-clock time back onto this process's timeline, the inverse of toSystem()
+     */
+    static time_point fromSystem(std::chrono::system_clock::time_point time);
+
+    /**
+     * Milliseconds since the Unix epoch, as rendered in JSON
+     * A default-constructed (never set) time point renders as 0
+     */
+    static int64_t toUnixMillis(time_point time);
+
+    /**
+     * @return true if now() reads the TSC, false if it uses steady_clock
+     */
+    static bool usesTsc();
+};
+
+} // namespace velocore
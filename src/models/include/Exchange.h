@@ -0,0 +1,175 @@
+#pragma once
+
+#include "OrderBook.h"
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace velocore {
+
+/**
+ * Exchange - Registry of one OrderBook per symbol.
+ *
+ * Orders are routed to the book for their symbol, so different instruments
+ * never match against each other and never contend on the same book lock.
+ * The registry lock is only taken exclusively when a new symbol is first
+ * seen; books are never removed, so references handed out stay valid for
+ * the lifetime of the Exchange.
+ */
+class Exchange {
+private:
+    std::unordered_map<SymbolId, std::unique_ptr<OrderBook>> books;
+    mutable std::shared_mutex booksMutex;
+    
+    // Trade log settings applied to books as they are created
+    size_t tradeLogCapacity = TradeLog::DEFAULT_CAPACITY;
+    std::string tradeSpillDirectory;
+
+public:
+    Exchange() = default;
+    ~Exchange() = default;
+
+    Exchange(const Exchange&) = delete;
+    Exchange& operator=(const Exchange&) = delete;
+    
+    /**
+     * Sets how books created from now on keep their trade history
+     * @param capacity Recent trades each book keeps in memory
+     * @param spillDirectory Directory older trades are written to as <symbol>.trades,
+     *        or empty to drop them
+     * @note Thread-safe - acquires exclusive lock; existing books are unaffected
+     */
+    void configureTradeLogs(size_t capacity, const std::string& spillDirectory);
+
+    /**
+     * Gets the book for a symbol, creating it with the symbol's tick size if needed
+     * @param symbol The instrument symbol
+     * @return Reference to the symbol's order book
+     * @note Thread-safe - acquires shared lock, exclusive only on first use of a symbol
+     */
+    OrderBook& getOrCreateBook(SymbolId symbol);
+
+    /**
+     * Gets the book for a symbol if it exists
+     * @param symbol The instrument symbol
+     * @return Pointer to the order book, or nullptr if the symbol has no book
+     * @note Thread-safe - acquires shared lock
+     */
+    OrderBook* findBook(SymbolId symbol) const;
+
+    /**
+     * Resolves a ticker from a request to a symbol that can be traded, one that
+     * already has a book. Never interns the ticker, so unknown tickers cost nothing.
+     * @param symbol The ticker as the client sent it
+     * @return The symbol's id, or the empty SymbolId if it has no book
+     * @note Thread-safe - acquires shared lock
+     */
+    SymbolId findListedSymbol(const std::string& symbol) const;
+
+    /**
+     * Routes an order to its symbol's book and matches it there
+     * @param order The order to add/match
+     * @return Vector of trades generated from this order
+     * @note Thread-safe - only the symbol's book is locked exclusively
+     */
+    std::vector<Trade> addOrder(const Order& order);
+    
+    /**
+     * Routes a batch of orders to their books, matching each symbol's orders
+     * in arrival order under a single acquisition of that book's lock
+     * @param orders Orders to add/match, possibly for several symbols
+     * @return Trades generated by each order, parallel to orders
+     * @note Thread-safe - each touched book is locked exclusively once
+     */
+    std::vector<std::vector<Trade>> addOrders(const std::vector<Order>& orders);
+
+    /**
+     * Cancels an order in a known symbol's book
+     * @param symbol The order's symbol
+     * @param orderId The ID of the order to cancel
+     * @return true if order was found and cancelled, false otherwise
+     * @note Thread-safe
+     */
+    bool cancelOrder(SymbolId symbol, uint64_t orderId);
+
+    /**
+     * Cancels an order without knowing its symbol by asking every book
+     * Each book lookup is constant time, so this is O(number of symbols)
+     * @param orderId The ID of the order to cancel
+     * @return true if order was found and cancelled, false otherwise
+     * @note Thread-safe
+     */
+    bool cancelOrder(uint64_t orderId);
+
+    /**
+     * Amends a resting order in a known symbol's book
+     * @param symbol The order's symbol
+     * @param orderId The ID of the order to amend
+     * @param newPrice The new limit price
+     * @param newQuantity The new total quantity
+     * @return Trades generated by the amended order, or std::nullopt if not found
+     * @throws std::invalid_argument if the new price or quantity is invalid
+     * @note Thread-safe
+     */
+    std::optional<std::vector<Trade>> amendOrder(SymbolId symbol, uint64_t orderId,
+                                                 Price newPrice, int newQuantity);
+    
+    /**
+     * Looks up a resting order in every book
+     * @param orderId The ID of the order to find
+     * @return Copy of the resting order, or std::nullopt if no book holds it
+     * @note Thread-safe
+     */
+    std::optional<Order> findOrder(uint64_t orderId) const;
+    
+    /**
+     * Gets every symbol that has a book
+     * @return Symbols in no particular order
+     * @note Thread-safe - acquires shared lock
+     */
+    std::vector<SymbolId> getSymbols() const;
+
+    /**
+     * Gets the in-memory trades of every book merged in time order
+     * @return Copy of the recent trades of every book
+     * @note Thread-safe
+     */
+    std::vector<Trade> getTradeLog() const;
+
+    /**
+     * Looks up an in-memory trade by id in the book that made it
+     * @param tradeId The ID of the trade to find
+     * @return Copy of the trade, or std::nullopt if no book holds it
+     * @note Thread-safe
+     */
+    std::optional<Trade> findTrade(uint64_t tradeId) const;
+    
+    /**
+     * Gets a page of in-memory trades newer than a cursor across every book
+     * @param sinceId Only trades after this one in time order are returned, 0 for
+     *        the oldest in memory; a cursor no longer in memory also restarts there
+     * @param limit Maximum number of trades to return
+     * @return Up to limit trades in time order, ties broken by id. Only trades
+     *         stamped before the call are returned, so a trade can never land
+     *         behind a cursor already handed out; newer ones come on the next call
+     * @note Thread-safe
+     */
+    std::vector<Trade> getTradesSince(uint64_t sinceId, size_t limit) const;
+    
+    /**
+     * Gets the total number of active orders across all books
+     * @note Thread-safe
+     */
+    size_t getTotalOrders() const;
+
+    /**
+     * Gets the total number of trades across all books
+     * @note Thread-safe
+     */
+    size_t getTradeCount() const;
+};
+
+} // namespace velocore
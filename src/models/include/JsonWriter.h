@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace velocore {
+
+/**
+ * JsonWriter - Streams JSON text straight into a caller-owned buffer.
+ *
+ * Unlike crow::json::wvalue there is no document tree: each value is
+ * appended as text as soon as it is written, so serializing a record costs
+ * no allocations beyond the buffer growing. Callers that keep one buffer
+ * and clear() it between responses reach a steady state with none at all.
+ * Commas are inserted automatically; keys and values must alternate
+ * inside objects. Nesting is limited to MAX_DEPTH levels.
+ */
+class JsonWriter {
+public:
+    static constexpr int MAX_DEPTH = 64;
+
+    /**
+     * @param buffer Output is appended to it
+     */
+    explicit JsonWriter(std::string& buffer) : out(buffer) {}
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    /**
+     * Writes an object key; the next call writes its value
+     */
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view text);
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(const std::string& text) { return value(std::string_view(text)); }
+    JsonWriter& value(bool flag);
+
+    /**
+     * Writes the shortest text that reads back as the same double;
+     * NaN and infinities, which JSON cannot represent, are written as null
+     */
+    JsonWriter& value(double number);
+
+    template<typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+    JsonWriter& value(T number) {
+        if constexpr (std::is_signed_v<T>) {
+            return integer(static_cast<int64_t>(number));
+        } else {
+            return unsignedInteger(static_cast<uint64_t>(number));
+        }
+    }
+
+    JsonWriter& null();
+
+    /**
+     * Writes already serialized JSON as the next value, unchecked
+     */
+    JsonWriter& raw(std::string_view json);
+
+    /**
+     * Writes a key and its value
+     */
+    template<typename T>
+    JsonWriter& field(std::string_view name, const T& fieldValue) {
+        key(name);
+        return value(fieldValue);
+    }
+
+    std::string& buffer() { return out; }
+
+private:
+    std::string& out;
+
+    // Bit n is set once the container at depth n has its first element
+    uint64_t hasElements = 0;
+    int depth = 0;
+    bool afterKey = false;
+
+    JsonWriter& integer(int64_t number);
+    JsonWriter& unsignedInteger(uint64_t number);
+
+    // Writes the comma before a value or key unless it is the first in its container
+    void separate();
+    void open(char bracket);
+    void close(char bracket);
+    void appendEscaped(std::string_view text);
+};
+
+} // namespace velocore
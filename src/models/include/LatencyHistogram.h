@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Clock.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace velocore {
+
+/**
+ * Stages of the order path that are timed, each with its own histogram
+ */
+enum class LatencyStage : uint8_t {
+    RequestParse,     // Request body to JSON document
+    Validation,       // Order field checks
+    LockWait,         // Waiting for the book lock
+    Matching,         // Matching and resting, under the book lock
+    Serialization,    // Building the JSON response
+    OrderRequest,     // A whole POST /orders request
+    Count
+};
+
+const char* to_string(LatencyStage stage);
+
+/**
+ * LatencySnapshot - Merged counts of one or more LatencyHistograms.
+ */
+struct LatencySnapshot {
+    std::vector<uint64_t> counts;    // Indexed like LatencyHistogram buckets
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+
+    /**
+     * @param quantile Between 0 and 1
+     * @return Upper bound of the bucket holding that quantile, in nanoseconds,
+     *         within 1 / LatencyHistogram::SUB_BUCKET_COUNT of the true value;
+     *         0 if nothing was recorded
+     */
+    uint64_t percentile(double quantile) const;
+};
+
+/**
+ * LatencyHistogram - HDR-style histogram of nanosecond durations.
+ *
+ * Values below 2 * SUB_BUCKET_COUNT get a bucket each. Above that, each
+ * power of two is split into SUB_BUCKET_COUNT equal buckets, so every
+ * recorded value is known to within about 3% across the whole 64-bit
+ * range with a fixed 1920 counters. Recording is a handful of relaxed
+ * stores with no read-modify-write, which is only correct with a single
+ * writer; readers on other threads may run at any time.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    LatencyHistogram() = default;
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @note NOT thread-safe - one writer only, concurrent readers are fine
+     */
+    void record(uint64_t nanos);
+
+    /**
+     * Adds this histogram's counts to a snapshot
+     * @note Thread-safe - a read racing record() may miss that one value
+     */
+    void mergeInto(LatencySnapshot& snapshot) const;
+
+    static size_t bucketFor(uint64_t nanos);
+
+    /**
+     * @return The largest value that lands in the bucket
+     */
+    static uint64_t bucketUpperBound(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts{};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+};
+
+/**
+ * Records a duration in the calling thread's histogram for the stage
+ * Each thread is given its own set of histograms on first use, so
+ * recording never contends; a thread's set is handed to the next new
+ * thread after it exits, keeping its counts.
+ * @note Thread-safe - lock-free except for a thread's first call
+ */
+void record_latency(LatencyStage stage, std::chrono::nanoseconds duration);
+
+inline void record_latency(LatencyStage stage, Clock::time_point start) {
+    record_latency(stage, std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start));
+}
+
+/**
+ * Merges every thread's histogram for the stage
+ * @note Thread-safe - never blocks recording threads
+ */
+LatencySnapshot latency_snapshot(LatencyStage stage);
+
+/**
+ * Renders every stage in the Prometheus text exposition format, as a
+ * summary with p50/p99/p99.9 quantiles plus a max gauge
+ * @note Thread-safe - never blocks recording threads
+ */
+std::string latency_metrics_prometheus();
+
+/**
+ * ScopedLatency - Records the time from construction to destruction
+ */
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyStage stage) : stage(stage), start(Clock::now()) {}
+    ~ScopedLatency() { record_latency(stage, start); }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyStage stage;
+    Clock::time_point start;
+};
+
+} // namespace velocore
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "Clock.h"
+#include "Symbol.h"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+namespace velocore {
+
+enum class LogLevel : uint8_t {
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off
+};
+
+/**
+ * Parses a GeneralConfig::log_level value, case-insensitively
+ * @return The level, or Info for an unrecognised name
+ */
+LogLevel log_level_from_string(const std::string& level);
+
+const char* to_string(LogLevel level);
+
+/**
+ * LogRecord - One message as the producing thread captured it.
+ *
+ * Arguments are copied in binary form (see LogRecordWriter), so the
+ * producer never formats numbers or touches a stream; the logger thread
+ * turns the record into text.
+ */
+struct alignas(64) LogRecord {
+    static constexpr size_t PAYLOAD_BYTES = 512 - 16;
+
+    Clock::time_point time;
+    LogLevel level = LogLevel::Info;
+    bool truncated = false;
+    uint16_t size = 0;
+    char payload[PAYLOAD_BYTES];
+};
+
+/**
+ * LogRecordWriter - Appends tagged arguments to a record's payload.
+ * Arguments that do not fit are dropped and the record marked truncated.
+ */
+class LogRecordWriter {
+public:
+    enum Tag : uint8_t { Bool, Char, Int, UInt, Double, String, Symbol };
+
+    explicit LogRecordWriter(LogRecord& record) : record(record) {}
+
+    void put(bool value) { putValue(Bool, value); }
+    void put(char value) { putValue(Char, value); }
+    void put(double value) { putValue(Double, value); }
+    void put(float value) { putValue(Double, static_cast<double>(value)); }
+    void put(SymbolId value) { putValue(Symbol, value.value); }
+    void put(const char* value) { put(std::string_view(value ? value : "")); }
+    void put(const std::string& value) { put(std::string_view(value)); }
+    void put(std::string_view value);
+
+    template<typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    void put(T value) {
+        if constexpr (std::is_signed_v<T>) {
+            putValue(Int, static_cast<int64_t>(value));
+        } else {
+            putValue(UInt, static_cast<uint64_t>(value));
+        }
+    }
+
+private:
+    LogRecord& record;
+
+    template<typename T>
+    void putValue(Tag tag, T value) {
+        if (record.size + 1 + sizeof(T) > LogRecord::PAYLOAD_BYTES) {
+            record.truncated = true;
+            return;
+        }
+        record.payload[record.size] = static_cast<char>(tag);
+        std::memcpy(record.payload + record.size + 1, &value, sizeof(T));
+        record.size = static_cast<uint16_t>(record.size + 1 + sizeof(T));
+    }
+};
+
+/**
+ * Logger - Asynchronous logger that keeps I/O off the calling thread.
+ *
+ * Each producing thread gets its own single-producer ring of LogRecords on
+ * first use and only copies its arguments into the next free slot. One
+ * background thread drains every ring, formats the records and writes
+ * them to the sink, flushing once per batch rather than once per line. A
+ * producer never blocks or takes a lock after its first message: if its
+ * ring is full the message is dropped and counted, and the logger reports
+ * how many were lost. Messages from one thread keep their order.
+ */
+class Logger {
+public:
+    static constexpr size_t RING_CAPACITY = 256;    // Records per thread, a power of two
+
+    /**
+     * The process-wide logger, writing to std::cout until setSink is called
+     */
+    static Logger& instance();
+
+    /**
+     * Writes out everything still queued, then stops the background thread
+     */
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void setLevel(LogLevel level) { minimumLevel.store(level, std::memory_order_relaxed); }
+    LogLevel getLevel() const { return minimumLevel.load(std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return level >= getLevel() && level != LogLevel::Off; }
+
+    /**
+     * Writes out everything queued so far to the old sink, then switches
+     * @param sink Stream the background thread writes to; must outlive its use
+     * @note Thread-safe
+     */
+    void setSink(std::ostream& sink);
+
+    /**
+     * Queues a message made of its arguments written back to back, as with
+     * operator<< on a stream
+     * @note Thread-safe - lock-free except for a thread's first message
+     */
+    template<typename... Args>
+    void log(LogLevel level, const Args&... args) {
+        if (!enabled(level)) {
+            return;
+        }
+        LogRecord* record = claim();
+        if (!record) {
+            return;
+        }
+        record->time = Clock::now();
+        record->level = level;
+        record->truncated = false;
+        record->size = 0;
+        LogRecordWriter writer(*record);
+        (writer.put(args), ...);
+        publish();
+    }
+
+    /**
+     * Blocks until every message queued before the call has been written
+     * @note Thread-safe
+     */
+    void flush();
+
+    /**
+     * @return Messages dropped because their thread's ring was full
+     */
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    // Single-producer single-consumer ring owned by one thread at a time
+    struct Ring {
+        std::array<LogRecord, RING_CAPACITY> records;
+        alignas(64) std::atomic<uint64_t> head{0};    // Next record to write, producer only
+        alignas(64) std::atomic<uint64_t> tail{0};    // Next record to read, logger thread only
+        std::atomic<bool> inUse{false};    // Owned by a live thread
+    };
+
+    // Hands a ring back to the logger when its thread exits
+    struct RingLease {
+        Ring* ring = nullptr;
+        ~RingLease();
+    };
+
+    std::ostream* sink;
+    std::atomic<LogLevel> minimumLevel{LogLevel::Info};
+    std::atomic<uint64_t> dropped{0};
+    uint64_t reportedDropped = 0;
+
+    // Rings are never freed, so a deque keeps their addresses stable as it grows
+    std::mutex ringsMutex;
+    std::deque<Ring> rings;
+
+    // Background thread state, and the sink, guarded by wakeMutex
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable flushedCondition;
+    uint64_t flushRequests = 0;
+    uint64_t flushesDone = 0;
+    bool stopping = false;
+    std::thread worker;
+
+    Logger();
+
+    Ring& threadRing();
+    LogRecord* claim();
+    void publish();
+
+    /**
+     * Writes out every queued record
+     * @return true if anything was written
+     * @note Background thread only
+     */
+    bool drain();
+    void run();
+};
+
+/**
+ * Logs to Logger::instance() at the named level
+ */
+template<typename... Args>
+void log_debug(const Args&... args) { Logger::instance().log(LogLevel::Debug, args...); }
+
+template<typename... Args>
+void log_info(const Args&... args) { Logger::instance().log(LogLevel::Info, args...); }
+
+template<typename... Args>
+void log_warn(const Args&... args) { Logger::instance().log(LogLevel::Warn, args...); }
+
+template<typename... Args>
+void log_error(const Args&... args) { Logger::instance().log(LogLevel::Error, args...); }
+
+} // namespace velocore
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Order.h"
+#include "PriceLevels.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace velocore {
+
+/**
+ * Side traits - how an incoming order sees the opposite side of the book.
+ *
+ * The matching loop is written once against these, and the side is chosen
+ * once per order, so the price comparison and buyer/seller roles are
+ * resolved at compile time inside the loop. Market orders use a limit that
+ * crosses every price, so they need no separate branch.
+ */
+struct BuySide {
+    // An incoming buy trades against asks at or below its limit
+    static constexpr bool crosses(Price limit, Price restingPrice) { return limit >= restingPrice; }
+    static constexpr Price marketLimit() { return Price(std::numeric_limits<int64_t>::max()); }
+
+    static uint64_t buyerId(const Order& incoming, const OrderNode&) { return incoming.id; }
+    static uint64_t sellerId(const Order&, const OrderNode& resting) { return resting.id; }
+};
+
+struct SellSide {
+    // An incoming sell trades against bids at or above its limit
+    static constexpr bool crosses(Price limit, Price restingPrice) { return limit <= restingPrice; }
+    static constexpr Price marketLimit() { return Price(std::numeric_limits<int64_t>::min()); }
+
+    static uint64_t buyerId(const Order&, const OrderNode& resting) { return resting.id; }
+    static uint64_t sellerId(const Order& incoming, const OrderNode&) { return incoming.id; }
+};
+
+/**
+ * Matching policies - how an incoming quantity is shared out among the
+ * orders resting at one price level.
+ *
+ * allocate(level, quantity, fill) calls fill(node, amount) once per
+ * allocation, in execution order. fill may unlink and release the node, so
+ * policies read anything they need from a node, including its successor,
+ * before filling it. Allocations never exceed a node's remaining quantity
+ * and add up to min(quantity, level.quantity()).
+ */
+
+/**
+ * FifoMatching - Price-time priority: the oldest order fills first.
+ */
+struct FifoMatching {
+    template<typename Fill>
+    static void allocate(PriceLevel& level, int quantity, Fill&& fill) {
+        OrderNode* node = level.front();
+        while (quantity > 0 && node) {
+            OrderNode* next = node->next;
+            int amount = std::min(quantity, node->remaining_quantity);
+            fill(node, amount);
+            quantity -= amount;
+            node = next;
+        }
+    }
+};
+
+/**
+ * ProRataMatching - Each order receives a share proportional to its size.
+ * Shares are rounded down and the few units lost to rounding go to the
+ * oldest orders first. If the incoming quantity covers the whole level,
+ * every order fills completely, exactly as under FIFO.
+ */
+struct ProRataMatching {
+    template<typename Fill>
+    static void allocate(PriceLevel& level, int quantity, Fill&& fill) {
+        if (quantity <= 0) {
+            return;
+        }
+
+        int64_t levelQuantity = level.quantity();
+        if (quantity >= levelQuantity) {
+            FifoMatching::allocate(level, quantity, fill);
+            return;
+        }
+
+        int allocated = 0;
+        OrderNode* node = level.front();
+        while (node) {
+            OrderNode* next = node->next;
+            int share = static_cast<int>(static_cast<int64_t>(quantity) * node->remaining_quantity / levelQuantity);
+            if (share > 0) {
+                fill(node, share);
+                allocated += share;
+            }
+            node = next;
+        }
+
+        // Rounding leftovers, fewer than the number of orders at the level
+        FifoMatching::allocate(level, quantity - allocated, fill);
+    }
+};
+
+/**
+ * TopOrderProRataMatching - The top (oldest) order at the level fills first
+ * and in full, then whatever remains is shared pro-rata among the rest.
+ * Rewards the order that set the level while still spreading the remainder.
+ */
+struct TopOrderProRataMatching {
+    template<typename Fill>
+    static void allocate(PriceLevel& level, int quantity, Fill&& fill) {
+        OrderNode* top = level.front();
+        if (!top || quantity <= 0) {
+            return;
+        }
+
+        int amount = std::min(quantity, top->remaining_quantity);
+        fill(top, amount);
+        ProRataMatching::allocate(level, quantity - amount, fill);
+    }
+};
+
+} // namespace velocore
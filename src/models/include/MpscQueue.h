@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace velocore {
+
+/**
+ * MpscQueue - Bounded lock-free multi-producer single-consumer ring buffer.
+ *
+ * Each cell carries a sequence number that tells producers whether the cell
+ * is free for the current lap and tells the consumer whether it has been
+ * published, so producers only contend on a single fetch/CAS of the enqueue
+ * position and never block each other while copying values in. Values live
+ * in raw cell storage and are only constructed while queued.
+ */
+template<typename T>
+class MpscQueue {
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    // Producers and the consumer write different positions, keep them on separate lines
+    alignas(CACHE_LINE) std::atomic<size_t> enqueuePos{0};
+    alignas(CACHE_LINE) size_t dequeuePos = 0;
+
+public:
+    /**
+     * @param capacity Maximum queued items, rounded up to a power of two
+     */
+    explicit MpscQueue(size_t capacity) {
+        size_t rounded = 2;
+        while (rounded < capacity) rounded *= 2;
+        cells = std::make_unique<Cell[]>(rounded);
+        mask = rounded - 1;
+        for (size_t i = 0; i < rounded; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MpscQueue() {
+        T discarded;
+        while (tryPop(discarded)) {}
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * Enqueues a value
+     * @return false if the queue is full, the value is left untouched
+     * @note Thread-safe for any number of producers
+     */
+    bool tryPush(T&& value) {
+        Cell* cell;
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->storage) T(std::move(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Dequeues the oldest published value
+     * @return false if nothing is ready
+     * @note Only one thread may consume
+     */
+    bool tryPop(T& out) {
+        Cell& cell = cells[dequeuePos & mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(dequeuePos + 1) < 0) {
+            return false;
+        }
+
+        out = std::move(*cell.value());
+        cell.value()->~T();
+        cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+};
+
+} // namespace velocore
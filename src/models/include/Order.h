@@ -1,6 +1,9 @@
 #pragma once
 
 #include "Types.h"
+#include "Price.h"
+#include "Symbol.h"
+#include "JsonWriter.h"
 #include <atomic>
 #include <chrono>
 #include <string>
@@ -11,21 +14,31 @@ namespace velocore {
 struct Order {
     uint64_t id;
     uint64_t client_id;  // Client ID for latency simulation
-    std::string symbol;
+    SymbolId symbol;
     Side side;
     OrderType type;
-    double price;
+    Price price;
     int quantity;
     int remaining_quantity;
     OrderStatus status;
+    uint64_t sequence;  // Time priority within its book, assigned on entry; 0 until then
     std::chrono::steady_clock::time_point timestamp;
     
     Order() = default;
     
-    Order(uint64_t client_id, const std::string& symbol, Side side, OrderType type, double price, int quantity);
+    Order(uint64_t client_id, SymbolId symbol, Side side, OrderType type, Price price, int quantity);
     
+    /**
+     * Allocates a unique order id
+     * Each thread reserves ORDER_ID_BLOCK ids at a time from the shared
+     * counter, so concurrent callers rarely touch the same cache line. Ids
+     * are unique but only increase within one thread.
+     * @note Thread-safe
+     */
     static uint64_t generate_id();
     
+    static constexpr uint64_t ORDER_ID_BLOCK = 1024;
+    
 private:
     static std::atomic<uint64_t> id_counter;
     
@@ -48,6 +61,7 @@ public:
     void cancel();
     
     crow::json::wvalue to_json() const;
+    void write_json(JsonWriter& writer) const;
     static Order from_json(const crow::json::rvalue& json);
 };
 
@@ -2,69 +2,138 @@
 
 #include "Order.h"
 #include "Trade.h"
-#include <map>
-#include <deque>
+#include "OrderPool.h"
+#include "PriceLevels.h"
+#include "MatchingPolicy.h"
+#include "SeqLock.h"
+#include "TradeLog.h"
+#include "RollingWindow.h"
 #include <vector>
+#include <optional>
 #include <shared_mutex>
 #include <memory>
 
 namespace velocore {
 
 /**
- * OrderBook - Core matching engine that maintains separate buy and sell books
- * and executes trades based on price-time priority.
+ * TopOfBook - Best bid/ask and last trade as of one book update.
+ * Prices are zero ticks and sizes zero when that side or trade is absent.
+ */
+struct TopOfBook {
+    Price bid_price;
+    int64_t bid_quantity = 0;
+    Price ask_price;
+    int64_t ask_quantity = 0;
+    Price last_trade_price;
+    int last_trade_quantity = 0;
+    uint64_t sequence = 0;    // Increments with every published update
+    
+    Price spread() const {
+        return (bid_quantity == 0 || ask_quantity == 0) ? Price() : ask_price - bid_price;
+    }
+};
+
+/**
+ * BasicOrderBook - Core matching engine that maintains separate buy and sell books
+ * and executes trades at the best available price.
  * 
+ * The price level storage is a template parameter so backends can be swapped
+ * without touching the matching logic (see PriceLevels.h). The matching
+ * policy decides how a fill is shared among the orders at one level, price-time
+ * FIFO by default (see MatchingPolicy.h); it is resolved at compile time, so
+ * the FIFO build pays nothing for the alternatives. Use the aliases below
+ * rather than this name.
  */
-class OrderBook {
+template<template<typename> class Levels, typename MatchingPolicy = FifoMatching>
+class BasicOrderBook {
 private:
+    // Storage for every resting order, linked into the levels below
+    OrderPool orderPool;
+    
     // Buy book: price -> orders (highest price first)
-    std::map<double, std::deque<Order>, std::greater<double>> buyBook;
+    Levels<std::greater<Price>> buyBook;
     
     // Sell book: price -> orders (lowest price first)
-    std::map<double, std::deque<Order>, std::less<double>> sellBook;
+    Levels<std::less<Price>> sellBook;
+    
+    // Resting order id -> node, kept in sync with buyBook/sellBook
+    OrderIndex orderIndex;
+    
+    // Running totals for one side, so counts never require walking the levels
+    struct SideTotals {
+        size_t orders = 0;
+        int64_t quantity = 0;
+    };
+    SideTotals buyTotals;
+    SideTotals sellTotals;
+    
+    // Decimal value of one tick, used only when rendering prices
+    double tickSize;
+    
+    // Symbol this book trades, the high bits of its trade ids
+    SymbolId bookSymbol;
     
-    // Trade tracking
+    // Entry sequence of the next order, which defines time priority
+    uint64_t nextSequence;
+    
+    // Trade tracking, recent trades in memory and older ones optionally on disk
+    // Sequence number of the next trade, never reset so trade ids stay unique
     uint64_t nextTradeId;
-    std::vector<Trade> tradeLog;
+    TradeLog tradeLog;
+    
+    // Rolling 1s/1m/5m windows, updated as each trade executes
+    TradeAnalytics analytics;
+    
+    // Working copy of the order being matched, so the caller's order stays untouched
+    Order incomingOrder;
+    
+    // Top of book as of the last write, readable without bookMutex
+    TopOfBook topOfBook;
+    SeqLock<TopOfBook> publishedTop;
     
     // Thread safety
     mutable std::shared_mutex bookMutex;
     
     // Internal helper methods
     /**
-     * Attempts to match an incoming order against the opposite book
-     * @param order The incoming order to match
-     * @return Vector of trades generated from this matching attempt
+     * Matches an incoming order and rests any limit remainder
+     * @param order The incoming order, updated with its fills
+     * @param executions Trades generated from this order are appended here
      * @note NOT thread-safe - caller must hold exclusive lock
      */
-    std::vector<Trade> matchOrder(Order& order);
+    void processOrder(Order& order, std::vector<Trade>& executions);
     
     /**
-     * Matches a buy order against the sell book
-     * @param buyOrder The incoming buy order
-     * @return Vector of trades generated
+     * Attempts to match an incoming order against the opposite book
+     * @param order The incoming order to match
+     * @param executions Trades generated from this matching attempt are appended here
      * @note NOT thread-safe - caller must hold exclusive lock
      */
-    std::vector<Trade> matchBuyOrder(Order& buyOrder);
+    void matchOrder(Order& order, std::vector<Trade>& executions);
     
     /**
-     * Matches a sell order against the buy book
-     * @param sellOrder The incoming sell order
-     * @return Vector of trades generated
+     * Matches an incoming order against the opposite book, level by level
+     * @param incoming The incoming order
+     * @param book The opposite side's levels
+     * @param totals The opposite side's running totals
+     * @param executions Trades generated are appended here
      * @note NOT thread-safe - caller must hold exclusive lock
      */
-    std::vector<Trade> matchSellOrder(Order& sellOrder);
+    template<typename SideTraits, typename BookType>
+    void matchAgainst(Order& incoming, BookType& book, SideTotals& totals, std::vector<Trade>& executions);
     
     /**
      * Executes a trade between two orders
-     * @param buyOrder The buy order
-     * @param sellOrder The sell order
+     * @param buyOrderId The buy order's ID
+     * @param sellOrderId The sell order's ID
+     * @param symbol The symbol both orders trade
      * @param executionPrice The price at which the trade occurs
      * @param quantity The quantity to trade
      * @return The created Trade object
      * @note NOT thread-safe - caller must hold exclusive lock
      */
-    Trade executeTrade(Order& buyOrder, Order& sellOrder, double executionPrice, int quantity);
+    Trade executeTrade(uint64_t buyOrderId, uint64_t sellOrderId, SymbolId symbol,
+                       Price executionPrice, int quantity);
     
     /**
      * Adds an order to the appropriate book (buy or sell)
@@ -75,40 +144,46 @@ private:
     void addToBook(const Order& order);
     
     /**
-     * Removes an order from a price level queue
+     * Unlinks a resting order from its price level queue and from the index,
+     * and returns its node to the pool
      * If the queue becomes empty, removes the entire price level
      * @param book Reference to the book (buy or sell)
-     * @param price The price level to remove from
+     * @param node The resting order's node
      * @note NOT thread-safe - caller must hold exclusive lock
      */
     template<typename BookType>
-    void removeFromPriceLevel(BookType& book, double price);
+    void removeFromPriceLevel(BookType& book, OrderNode* node);
     
     /**
-     * Checks if prices cross (can execute)
-     * @param buyPrice The buy order price
-     * @param sellPrice The sell order price
-     * @return true if prices cross (buy >= sell)
-     * @note Thread-safe (read-only operation)
+     * Refreshes topOfBook from the best levels and publishes it to readers
+     * @note NOT thread-safe - caller must hold exclusive lock
      */
-    bool pricesCross(double buyPrice, double sellPrice) const;
+    void publishTopOfBook();
+    
 
 public:
     /**
      * Constructor - initializes empty order book
+     * @param tickSize Decimal value of one price tick for this book's symbol
+     * @param tradeLogCapacity Number of recent trades kept in memory
+     * @param tradeSpillPath File older trades are appended to, or empty to drop them
+     * @param symbol Symbol this book trades, embedded in its trade ids (see make_trade_id)
      */
-    OrderBook();
+    explicit BasicOrderBook(double tickSize = DEFAULT_TICK_SIZE,
+                            size_t tradeLogCapacity = TradeLog::DEFAULT_CAPACITY,
+                            const std::string& tradeSpillPath = "",
+                            SymbolId symbol = SymbolId());
     
     /**
      * Destructor
      */
-    ~OrderBook() = default;
+    ~BasicOrderBook() = default;
     
-    OrderBook(const OrderBook&) = delete;
-    OrderBook& operator=(const OrderBook&) = delete;
+    BasicOrderBook(const BasicOrderBook&) = delete;
+    BasicOrderBook& operator=(const BasicOrderBook&) = delete;
     
-    OrderBook(OrderBook&&) = delete;
-    OrderBook& operator=(OrderBook&&) = delete;
+    BasicOrderBook(BasicOrderBook&&) = delete;
+    BasicOrderBook& operator=(BasicOrderBook&&) = delete;
     
     /**
      * Adds a new order and executes matches if possible
@@ -119,7 +194,28 @@ public:
     std::vector<Trade> addOrder(Order order);
     
     /**
-     * Attempts to cancel an order by ID
+     * Adds a new order and reports its executions into a caller-owned buffer
+     * Once the buffer, the trade log and the touched price levels have
+     * capacity, matching and resting an order does not allocate, so hot
+     * callers should keep one buffer and clear() it between orders
+     * @param order The order to add/match
+     * @param executions Trades generated from this order are appended here
+     * @return Number of trades appended
+     * @note Thread-safe - acquires exclusive lock
+     */
+    size_t addOrder(const Order& order, std::vector<Trade>& executions);
+    
+    /**
+     * Adds a batch of orders, matching each in sequence under one lock acquisition
+     * Produces the same trades as calling addOrder for each order in turn
+     * @param orders Orders to add/match, in arrival order
+     * @return Trades generated by each order, parallel to orders
+     * @note Thread-safe - acquires exclusive lock once for the whole batch
+     */
+    std::vector<std::vector<Trade>> addOrders(const std::vector<Order>& orders);
+    
+    /**
+     * Attempts to cancel an order by ID in constant time via the order index
      * @param orderId The ID of the order to cancel
      * @return true if order was found and cancelled, false otherwise
      * @note Thread-safe - acquires exclusive lock
@@ -127,28 +223,75 @@ public:
     bool cancelOrder(uint64_t orderId);
     
     /**
-     * Gets the current best bid price (highest buy price)
-     * @return Best bid price, or 0.0 if no bids exist
+     * Amends a resting order's price and/or total quantity as one operation
+     * Reducing only the quantity keeps the order's place in its queue. Any
+     * other change re-queues it behind its new level, matching first if the
+     * new price crosses, and the order keeps its ID.
+     * @param orderId The ID of the order to amend
+     * @param newPrice The new limit price
+     * @param newQuantity The new total quantity, including what has already filled
+     * @return Trades generated by the amended order, or std::nullopt if no such resting order
+     * @throws std::invalid_argument if newPrice is not positive or newQuantity
+     *         does not exceed the already filled quantity
+     * @note Thread-safe - acquires exclusive lock
+     */
+    std::optional<std::vector<Trade>> amendOrder(uint64_t orderId, Price newPrice, int newQuantity);
+    
+    /**
+     * Looks up a resting order by ID in constant time
+     * @param orderId The ID of the order to find
+     * @return Copy of the resting order, or std::nullopt if it is not in the book
      * @note Thread-safe - acquires shared lock
      */
-    double getBestBid() const;
+    std::optional<Order> findOrder(uint64_t orderId) const;
+    
+    /**
+     * Gets the best bid/ask, their sizes and the last trade as one consistent record
+     * Published by every write, so readers never wait on the book lock
+     * @return Top of book as of the most recent completed write
+     * @note Thread-safe - lock-free, never acquires the book lock
+     */
+    TopOfBook getTopOfBook() const { return publishedTop.load(); }
+    
+    /**
+     * Gets a number that grows with every write that changes the book or its trades,
+     * for telling whether anything derived from the book is out of date
+     * @return The sequence of the latest published top of book
+     * @note Thread-safe - lock-free, never acquires the book lock
+     */
+    uint64_t getVersion() const { return publishedTop.load().sequence; }
+    
+    /**
+     * Gets the current best bid price (highest buy price)
+     * @return Best bid price, or zero ticks if no bids exist
+     * @note Thread-safe - lock-free, reads the published top of book
+     */
+    Price getBestBid() const;
     
     /**
      * Gets the current best ask price (lowest sell price)
-     * @return Best ask price, or 0.0 if no asks exist
-     * @note Thread-safe - acquires shared lock
+     * @return Best ask price, or zero ticks if no asks exist
+     * @note Thread-safe - lock-free, reads the published top of book
      */
-    double getBestAsk() const;
+    Price getBestAsk() const;
     
     /**
      * Gets the current bid-ask spread
-     * @return Spread (ask - bid), or 0.0 if either side is empty
-     * @note Thread-safe - acquires shared lock
+     * @return Spread (ask - bid), or zero ticks if either side is empty
+     * @note Thread-safe - lock-free, reads the published top of book
      */
-    double getSpread() const;
+    Price getSpread() const;
+    
+    /**
+     * Gets the decimal value of one price tick
+     * @return Tick size this book was created with
+     * @note Thread-safe (immutable after construction)
+     */
+    double getTickSize() const { return tickSize; }
     
     /**
      * Gets the top N price levels for both sides
+     * Level quantities are cached, so this costs O(levels) rather than O(orders)
      * @param levels Number of levels to retrieve
      * @return JSON representation of the order book
      * @note Thread-safe - acquires shared lock
@@ -156,27 +299,94 @@ public:
     crow::json::wvalue getBookSnapshot(size_t levels = 5) const;
     
     /**
-     * Gets all trades executed so far
-     * @return Copy of the trade log
+     * Streams the same snapshot as getBookSnapshot, without building a wvalue
+     * @param writer Receives one JSON object
+     * @param levels Number of levels to write
+     * @note Thread-safe - acquires shared lock
+     */
+    void writeBookSnapshot(JsonWriter& writer, size_t levels = 5) const;
+    
+    /**
+     * Gets the trades still held in memory
+     * @return Copy of the recent trades, oldest first
      * @note Thread-safe - acquires shared lock
      */
     std::vector<Trade> getTradeLog() const;
     
     /**
-     * Gets the number of orders at each price level
-     * @return JSON with bid/ask level counts
+     * Looks up a trade still held in memory by id
+     * @param tradeId The ID of the trade to find
+     * @return Copy of the trade, or std::nullopt if it is unknown or evicted
+     * @note Thread-safe - acquires shared lock
+     */
+    std::optional<Trade> findTrade(uint64_t tradeId) const;
+    
+    /**
+     * Gets a page of in-memory trades newer than a cursor
+     * @param sinceId Only trades with a larger id are returned, 0 for the oldest in memory
+     * @param limit Maximum number of trades to return
+     * @return Up to limit trades in id order
+     * @note Thread-safe - acquires shared lock
+     */
+    std::vector<Trade> getTradesSince(uint64_t sinceId, size_t limit) const;
+    
+    /**
+     * Gets a page of in-memory trades ordered after a trade from any book
+     * @param cursor Only trades later by time, then id, are returned
+     * @param limit Maximum number of trades to return
+     * @return Up to limit trades in time order
+     * @note Thread-safe - acquires shared lock
+     */
+    std::vector<Trade> getTradesAfter(const Trade& cursor, size_t limit) const;
+    
+    /**
+     * Visits the trades still held in memory without copying them
+     * @param visitor Called with each trade, oldest first; return false to stop
+     * @note Thread-safe - holds the shared lock while visiting, so the
+     *       visitor must not call back into this book's write methods
+     */
+    template<typename Visitor>
+    void forEachTrade(Visitor&& visitor) const {
+        std::shared_lock<std::shared_mutex> lock(bookMutex);
+        for (const Trade& trade : tradeLog) {
+            if (!visitor(trade)) {
+                return;
+            }
+        }
+    }
+    
+    /**
+     * Gets VWAP, OHLCV and trade rate over the last 1 second, 1 minute and 5 minutes
+     * Each window is merged from a fixed number of buckets, however many trades it holds
+     * @return JSON keyed "1s", "1m" and "5m"
+     * @note Thread-safe - acquires shared lock
+     */
+    crow::json::wvalue getAnalytics() const;
+    
+    /**
+     * Gets one rolling window as of now
+     * @param window 0 for 1 second, 1 for 1 minute, 2 for 5 minutes
+     * @note Thread-safe - acquires shared lock
+     */
+    WindowSummary getWindowSummary(size_t window) const;
+    
+    /**
+     * Gets the level, order and quantity totals for each side
+     * Served from running totals in constant time
+     * @return JSON with bid/ask level, order and quantity counts
      * @note Thread-safe - acquires shared lock
      */
     crow::json::wvalue getBookStatistics() const;
     
     /**
      * Clears all orders and trades
+     * Trade sequence numbers carry on from where they were, so ids are never reused
      * @note Thread-safe - acquires exclusive lock
      */
     void clear();
     
     /**
-     * Gets the total number of active orders in the book
+     * Gets the total number of active orders in the book in constant time
      * @return Total order count
      * @note Thread-safe - acquires shared lock
      */
@@ -191,10 +401,36 @@ public:
     
     /**
      * Gets the current trade count
-     * @return Number of executed trades
+     * @return Number of executed trades, including those no longer in memory
      * @note Thread-safe - acquires shared lock
      */
     size_t getTradeCount() const;
 };
 
+// std::map levels: any price range, one tree node per level
+using MapOrderBook = BasicOrderBook<MapPriceLevels>;
+
+// Tick-indexed ladder levels: O(1) best price, add and sweep near the touch
+using LadderOrderBook = BasicOrderBook<LadderPriceLevels>;
+
+extern template class BasicOrderBook<MapPriceLevels, FifoMatching>;
+extern template class BasicOrderBook<MapPriceLevels, ProRataMatching>;
+extern template class BasicOrderBook<MapPriceLevels, TopOrderProRataMatching>;
+extern template class BasicOrderBook<LadderPriceLevels, FifoMatching>;
+extern template class BasicOrderBook<LadderPriceLevels, ProRataMatching>;
+extern template class BasicOrderBook<LadderPriceLevels, TopOrderProRataMatching>;
+
+// Backend used by the server, selected with the VELOCORE_LADDER_BOOK build option
+#ifdef VELOCORE_LADDER_BOOK
+template<typename MatchingPolicy>
+using PolicyOrderBook = BasicOrderBook<LadderPriceLevels, MatchingPolicy>;
+#else
+template<typename MatchingPolicy>
+using PolicyOrderBook = BasicOrderBook<MapPriceLevels, MatchingPolicy>;
+#endif
+
+using OrderBook = PolicyOrderBook<FifoMatching>;
+using ProRataOrderBook = PolicyOrderBook<ProRataMatching>;
+using TopOrderProRataOrderBook = PolicyOrderBook<TopOrderProRataMatching>;
+
 } // namespace velocore 
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "Types.h"
+#include "Price.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace velocore {
+
+/**
+ * Binary order entry protocol - fixed-size little-endian messages over TCP.
+ *
+ * Every message starts with a 4-byte header: total length (u16), type (u8)
+ * and a reserved byte. Each type has exactly one length, so a reader takes
+ * the header, checks the length against the type and reads the rest in one
+ * go. Prices are whole ticks of the symbol's tick size, the engine's own
+ * representation, so nothing is parsed or rounded on the way in.
+ *
+ * A session answers each request with one Ack or one Reject, in request
+ * order. Fills follow the Ack for what the request matched immediately
+ * (liquidity Removed), and arrive later for resting orders hit by others
+ * (liquidity Added); an order's open quantity is the Ack's leaves minus the
+ * Added fills after it.
+ */
+enum class OrderEntryMessageType : uint8_t {
+    NewOrder = 0x01,
+    Cancel = 0x02,
+    Amend = 0x03,
+    Ack = 0x81,
+    Fill = 0x82,
+    Reject = 0x83
+};
+
+enum class RejectReason : uint8_t {
+    InvalidMessage = 1,
+    InvalidSymbol = 2,
+    InvalidQuantity = 3,
+    InvalidPrice = 4,
+    UnknownOrder = 5,
+    InvalidAmend = 6
+};
+
+enum class Liquidity : uint8_t {
+    Added = 1,      // The order was resting
+    Removed = 2     // The order traded on entry or amend
+};
+
+constexpr size_t ORDER_ENTRY_HEADER_SIZE = 4;
+
+// Longest ticker that fits a message
+constexpr size_t ORDER_ENTRY_SYMBOL_SIZE = 8;
+
+struct OrderEntryHeader {
+    uint16_t length = 0;
+    OrderEntryMessageType type = OrderEntryMessageType::NewOrder;
+};
+
+// Offsets: 4 client_order_id u64, 12 symbol char[8] NUL-padded, 20 side u8 (0 buy, 1 sell),
+// 21 type u8 (0 limit, 1 market), 24 quantity u32, 28 price i64
+struct NewOrderMessage {
+    static constexpr size_t SIZE = 36;
+    uint64_t client_order_id = 0;
+    std::string symbol;
+    Side side = Side::Buy;
+    OrderType type = OrderType::Limit;
+    uint32_t quantity = 0;
+    Price price;
+};
+
+// Offsets: 4 client_order_id u64, 12 order_id u64
+struct CancelMessage {
+    static constexpr size_t SIZE = 20;
+    uint64_t client_order_id = 0;
+    uint64_t order_id = 0;
+};
+
+// Offsets: 4 client_order_id u64, 12 order_id u64, 20 quantity u32, 24 price i64; 0 keeps the current value
+struct AmendMessage {
+    static constexpr size_t SIZE = 32;
+    uint64_t client_order_id = 0;
+    uint64_t order_id = 0;
+    uint32_t quantity = 0;
+    Price price;
+};
+
+// Offsets: 4 client_order_id u64, 12 order_id u64, 20 request u8, 24 leaves u32, 28 executed u32
+struct AckMessage {
+    static constexpr size_t SIZE = 32;
+    uint64_t client_order_id = 0;
+    uint64_t order_id = 0;
+    OrderEntryMessageType request = OrderEntryMessageType::NewOrder;
+    uint32_t leaves_quantity = 0;       // Still resting after the request, 0 once done
+    uint32_t executed_quantity = 0;     // Matched by the request itself
+};
+
+// Offsets: 4 client_order_id u64, 12 order_id u64, 20 trade_id u64, 28 price i64, 36 quantity u32, 40 liquidity u8
+struct FillMessage {
+    static constexpr size_t SIZE = 44;
+    uint64_t client_order_id = 0;       // Of the NewOrder that entered the order
+    uint64_t order_id = 0;
+    uint64_t trade_id = 0;
+    Price price;
+    uint32_t quantity = 0;
+    Liquidity liquidity = Liquidity::Removed;
+};
+
+// Offsets: 4 client_order_id u64, 12 order_id u64, 20 request u8, 21 reason u8
+struct RejectMessage {
+    static constexpr size_t SIZE = 24;
+    uint64_t client_order_id = 0;
+    uint64_t order_id = 0;
+    OrderEntryMessageType request = OrderEntryMessageType::NewOrder;
+    RejectReason reason = RejectReason::InvalidMessage;
+};
+
+// Largest message, enough for any receive buffer
+constexpr size_t ORDER_ENTRY_MAX_MESSAGE_SIZE = FillMessage::SIZE;
+
+/**
+ * Gets the length every message of a type has
+ * @return The length including the header, or 0 for an unknown type
+ */
+size_t order_entry_message_size(uint8_t type);
+
+/**
+ * Reads a message header
+ * @param in At least ORDER_ENTRY_HEADER_SIZE bytes
+ * @return false if the type is unknown or the length is not the one its type has
+ */
+bool decode_header(const uint8_t* in, OrderEntryHeader& header);
+
+/**
+ * Encoders write the whole message, header included, and return its length
+ * @param out At least the message's SIZE bytes
+ * @throws std::invalid_argument if a NewOrder symbol is empty or longer than ORDER_ENTRY_SYMBOL_SIZE
+ */
+size_t encode(const NewOrderMessage& message, uint8_t* out);
+size_t encode(const CancelMessage& message, uint8_t* out);
+size_t encode(const AmendMessage& message, uint8_t* out);
+size_t encode(const AckMessage& message, uint8_t* out);
+size_t encode(const FillMessage& message, uint8_t* out);
+size_t encode(const RejectMessage& message, uint8_t* out);
+
+/**
+ * Decoders read a whole message whose header has already been checked
+ * @return false if a field holds a value its enum does not have
+ */
+bool decode(const uint8_t* in, NewOrderMessage& message);
+bool decode(const uint8_t* in, CancelMessage& message);
+bool decode(const uint8_t* in, AmendMessage& message);
+bool decode(const uint8_t* in, AckMessage& message);
+bool decode(const uint8_t* in, FillMessage& message);
+bool decode(const uint8_t* in, RejectMessage& message);
+
+const char* to_string(RejectReason reason);
+
+} // namespace velocore
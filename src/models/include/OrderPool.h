@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Order.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace velocore {
+
+/**
+ * OrderNode - Hot record of a resting order, linked into its price level.
+ *
+ * Holds only what the matching loop touches while sweeping a level: the id,
+ * the remaining quantity and the queue links, packed into 32 bytes so two
+ * nodes share a cache line. The rest of the order (symbol, side, price,
+ * original quantity, entry time) is cold and lives in the owning pool's
+ * side table at `slot`, see OrderPool::details(). Nodes are owned by an
+ * OrderPool and linked intrusively, so queueing, filling and cancelling an
+ * order never allocates.
+ */
+struct alignas(32) OrderNode {
+    uint64_t id = 0;
+    int32_t remaining_quantity = 0;
+    uint32_t slot = 0;
+    OrderNode* prev = nullptr;
+    OrderNode* next = nullptr;
+};
+
+static_assert(sizeof(OrderNode) <= 32, "OrderNode must stay within half a cache line");
+
+/**
+ * OrderPool - Preallocated free list of OrderNodes and their cold details.
+ *
+ * Nodes are carved out of fixed-size chunks that are never freed while the
+ * pool lives, so node addresses stay stable. Each chunk has a parallel array
+ * of Orders holding the cold fields, indexed by the node's slot, so a level
+ * sweep walks densely packed hot records and never pulls cold data into
+ * cache. A new chunk is only allocated when every node is in use.
+ */
+class OrderPool {
+private:
+    struct Chunk {
+        std::unique_ptr<OrderNode[]> nodes;
+        std::unique_ptr<Order[]> details;
+    };
+
+    size_t chunkSize;
+    std::vector<Chunk> chunks;
+    OrderNode* freeList;
+    size_t nodesInUse;
+
+    void addChunk();
+
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 4096;
+
+    explicit OrderPool(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    OrderPool(const OrderPool&) = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
+
+    /**
+     * Takes a free node and copies the order into it and its details slot
+     * @param order The order to store
+     * @return Unlinked node holding the order's id and remaining quantity
+     */
+    OrderNode* acquire(const Order& order);
+
+    /**
+     * Gets the cold details of a node's order
+     * The remaining quantity and status there are as of acquire(); the node's
+     * remaining_quantity is the live value
+     */
+    Order& details(const OrderNode* node) {
+        return chunks[node->slot / chunkSize].details[node->slot % chunkSize];
+    }
+
+    const Order& details(const OrderNode* node) const {
+        return chunks[node->slot / chunkSize].details[node->slot % chunkSize];
+    }
+
+    /**
+     * Returns a node to the free list
+     * @param node A node previously returned by acquire, already unlinked
+     */
+    void release(OrderNode* node);
+
+    /**
+     * Returns every node to the free list without freeing any chunk
+     */
+    void releaseAll();
+
+    size_t capacity() const { return chunks.size() * chunkSize; }
+    size_t inUse() const { return nodesInUse; }
+};
+
+/**
+ * OrderIndex - Open-addressing hash table from order id to resting node.
+ *
+ * Linear probing over a flat slot array with backward-shift deletion, so
+ * insert and erase do not allocate unless the table has to grow past half
+ * full, and lookups touch one or two cache lines.
+ */
+class OrderIndex {
+private:
+    struct Slot {
+        uint64_t id = 0;
+        OrderNode* node = nullptr;
+    };
+
+    std::vector<Slot> slots;
+    size_t mask;
+    size_t count;
+
+    size_t slotFor(uint64_t id) const;
+    void grow();
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 8192;
+
+    explicit OrderIndex(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @return The node for the id, or nullptr if it is not indexed
+     */
+    OrderNode* find(uint64_t id) const;
+
+    /**
+     * Indexes a node, replacing any previous node with the same id
+     */
+    void insert(uint64_t id, OrderNode* node);
+
+    /**
+     * @return true if the id was indexed
+     */
+    bool erase(uint64_t id);
+
+    void clear();
+    size_t size() const { return count; }
+};
+
+} // namespace velocore
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Symbol.h"
+#include <cstdint>
+#include <string>
+
+namespace velocore {
+
+// Tick size used for symbols that have not been given an explicit one
+constexpr double DEFAULT_TICK_SIZE = 0.01;
+
+/**
+ * Price - Fixed-point price stored as an integer number of ticks.
+ * 
+ * The matching engine only ever compares and subtracts tick counts, so equal
+ * prices always land on the same book level. Conversion to and from double
+ * happens at the REST/JSON boundary using the symbol's tick size.
+ */
+struct Price {
+    int64_t ticks = 0;
+    
+    constexpr Price() = default;
+    constexpr explicit Price(int64_t ticks) : ticks(ticks) {}
+    
+    /**
+     * Rounds a decimal price to the nearest whole tick
+     * @param value The decimal price
+     * @param tick_size The minimum price increment, must be positive
+     * @return The price in ticks
+     * @throws std::invalid_argument if tick_size is not positive
+     */
+    static Price from_double(double value, double tick_size = DEFAULT_TICK_SIZE);
+    
+    double to_double(double tick_size = DEFAULT_TICK_SIZE) const;
+    
+    constexpr bool is_zero() const { return ticks == 0; }
+};
+
+constexpr bool operator==(Price lhs, Price rhs) { return lhs.ticks == rhs.ticks; }
+constexpr bool operator!=(Price lhs, Price rhs) { return lhs.ticks != rhs.ticks; }
+constexpr bool operator<(Price lhs, Price rhs) { return lhs.ticks < rhs.ticks; }
+constexpr bool operator>(Price lhs, Price rhs) { return lhs.ticks > rhs.ticks; }
+constexpr bool operator<=(Price lhs, Price rhs) { return lhs.ticks <= rhs.ticks; }
+constexpr bool operator>=(Price lhs, Price rhs) { return lhs.ticks >= rhs.ticks; }
+
+constexpr Price operator+(Price lhs, Price rhs) { return Price(lhs.ticks + rhs.ticks); }
+constexpr Price operator-(Price lhs, Price rhs) { return Price(lhs.ticks - rhs.ticks); }
+
+/**
+ * Per-symbol tick size registry, consulted only when converting prices
+ * to or from their decimal representation
+ */
+double tick_size_for(SymbolId symbol);
+double tick_size_for(const std::string& symbol);
+void set_tick_size(const std::string& symbol, double tick_size);
+
+} // namespace velocore
@@ -0,0 +1,459 @@
+#pragma once
+
+#include "Bits.h"
+#include "OrderPool.h"
+#include "Price.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <vector>
+
+namespace velocore {
+
+/**
+ * PriceLevel - Orders resting at a single price, oldest first.
+ *
+ * An intrusive doubly-linked list over pool-owned OrderNodes: the level only
+ * holds head/tail pointers, so appending and unlinking from anywhere in the
+ * queue are O(1) and never allocate. Nodes do not point back at their level,
+ * so a level can be moved or copied freely while it holds orders.
+ * The level keeps a running total of its remaining quantity so depth queries
+ * never walk the queue; fills must be reported through reduce().
+ */
+struct PriceLevel {
+    OrderNode* head = nullptr;
+    OrderNode* tail = nullptr;
+    size_t orderCount = 0;
+    int64_t totalQuantity = 0;
+    
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = OrderNode;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const OrderNode*;
+        using reference = const OrderNode&;
+        
+        explicit const_iterator(const OrderNode* node = nullptr) : node(node) {}
+        reference operator*() const { return *node; }
+        pointer operator->() const { return node; }
+        const_iterator& operator++() { node = node->next; return *this; }
+        bool operator==(const const_iterator& other) const { return node == other.node; }
+        bool operator!=(const const_iterator& other) const { return node != other.node; }
+        
+    private:
+        const OrderNode* node;
+    };
+    
+    bool empty() const { return head == nullptr; }
+    size_t size() const { return orderCount; }
+    int64_t quantity() const { return totalQuantity; }
+    OrderNode* front() const { return head; }
+    
+    const_iterator begin() const { return const_iterator(head); }
+    const_iterator end() const { return const_iterator(); }
+    
+    void push_back(OrderNode* node) {
+        node->prev = tail;
+        node->next = nullptr;
+        if (tail) {
+            tail->next = node;
+        } else {
+            head = node;
+        }
+        tail = node;
+        orderCount++;
+        totalQuantity += node->remaining_quantity;
+    }
+    
+    /**
+     * Unlinks a node from anywhere in the queue, the node itself is not freed
+     */
+    void erase(OrderNode* node) {
+        if (node->prev) {
+            node->prev->next = node->next;
+        } else {
+            head = node->next;
+        }
+        if (node->next) {
+            node->next->prev = node->prev;
+        } else {
+            tail = node->prev;
+        }
+        node->prev = nullptr;
+        node->next = nullptr;
+        orderCount--;
+        totalQuantity -= node->remaining_quantity;
+    }
+    
+    /**
+     * Records a fill against one of the level's orders
+     * Call alongside decrementing that order's remaining_quantity
+     */
+    void reduce(int quantity) {
+        totalQuantity -= quantity;
+    }
+    
+    /**
+     * Forgets every node, the caller is responsible for releasing them
+     */
+    void clear() {
+        head = nullptr;
+        tail = nullptr;
+        orderCount = 0;
+        totalQuantity = 0;
+    }
+};
+
+/**
+ * Price level containers used as order book backends.
+ *
+ * Both containers keep one side of the book ordered by Compare, so that
+ * best() is the level with the highest priority (std::greater for bids,
+ * std::less for asks), and expose the same small interface:
+ *   empty(), size(), bestPrice(), best(), operator[], find(), erase(),
+ *   clear() and forEach(visitor) in priority order.
+ * Levels may move when the container reorganizes, but the pooled nodes they
+ * link never do, so node pointers stay valid until the order is released.
+ */
+
+/**
+ * MapPriceLevels - Levels stored in a balanced tree keyed by price.
+ * Handles any price range, at the cost of a node allocation per new level
+ * and pointer chasing on best-price access.
+ */
+template<typename Compare>
+class MapPriceLevels {
+private:
+    std::map<Price, PriceLevel, Compare> levels;
+
+public:
+    bool empty() const { return levels.empty(); }
+    size_t size() const { return levels.size(); }
+
+    /**
+     * @note Undefined if empty()
+     */
+    Price bestPrice() const { return levels.begin()->first; }
+    PriceLevel& best() { return levels.begin()->second; }
+
+    /**
+     * Gets the level at a price, creating an empty one if needed
+     */
+    PriceLevel& operator[](Price price) { return levels[price]; }
+
+    PriceLevel* find(Price price) {
+        auto it = levels.find(price);
+        return it == levels.end() ? nullptr : &it->second;
+    }
+
+    const PriceLevel* find(Price price) const {
+        auto it = levels.find(price);
+        return it == levels.end() ? nullptr : &it->second;
+    }
+
+    void erase(Price price) { levels.erase(price); }
+    void clear() { levels.clear(); }
+
+    /**
+     * Visits levels from best to worst until the visitor returns false
+     * @param visit Callable as bool(Price, const PriceLevel&)
+     */
+    template<typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (const auto& [price, level] : levels) {
+            if (!visit(price, level)) break;
+        }
+    }
+};
+
+/**
+ * LadderPriceLevels - Levels stored in a contiguous array indexed by tick.
+ *
+ * The array covers a window of ticks starting at baseTick. An occupancy
+ * bitmap with one bit per slot finds the next non-empty level a 64-tick word
+ * at a time, and the best level index is cached, so best-price access, adding
+ * to an existing level and sweeping to the next level are O(1) in the common
+ * case. A price outside the window recenters it around the occupied range,
+ * doubling the capacity when the occupied range no longer fits comfortably.
+ * The window never grows past MAX_CAPACITY ticks; a price too far from the
+ * window's levels to fit rests in a sparse overflow map instead, so a stray
+ * far-away order costs a tree node rather than a huge allocation.
+ */
+template<typename Compare>
+class LadderPriceLevels {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+    static constexpr size_t MAX_CAPACITY = 65536;
+
+    explicit LadderPriceLevels(size_t capacity = DEFAULT_CAPACITY) {
+        size_t rounded = WORD_BITS;
+        while (rounded < capacity) rounded *= 2;
+        slots.resize(rounded);
+        occupied.resize(rounded / WORD_BITS, 0);
+    }
+
+    bool empty() const { return levelCount == 0 && overflow.empty(); }
+    size_t size() const { return levelCount + overflow.size(); }
+
+    /**
+     * Number of ticks the window currently covers
+     */
+    size_t capacity() const { return slots.size(); }
+
+    /**
+     * Number of levels held outside the window
+     */
+    size_t overflowSize() const { return overflow.size(); }
+
+    /**
+     * @note Undefined if empty()
+     */
+    Price bestPrice() const {
+        return overflowLeads() ? overflow.begin()->first : Price(baseTick + static_cast<int64_t>(bestIndex));
+    }
+    PriceLevel& best() { return overflowLeads() ? overflow.begin()->second : slots[bestIndex]; }
+
+    /**
+     * Gets the level at a price, creating an empty one if needed
+     * Recenters the window first if the price falls outside it, or keeps the
+     * level in the overflow map if the window cannot stretch that far
+     */
+    PriceLevel& operator[](Price price) {
+        size_t index = 0;
+        if (!indexOf(price, index)) {
+            auto it = overflow.find(price);
+            if (it != overflow.end()) {
+                return it->second;
+            }
+            if (!recenter(price)) {
+                return overflow[price];
+            }
+            indexOf(price, index);
+        }
+
+        if (!isOccupied(index)) {
+            mark(index);
+            if (levelCount == 0 || ranksBefore(index, bestIndex)) {
+                bestIndex = index;
+            }
+            levelCount++;
+        }
+        return slots[index];
+    }
+
+    PriceLevel* find(Price price) {
+        size_t index = 0;
+        if (!indexOf(price, index)) {
+            return findOverflow(price);
+        }
+        return isOccupied(index) ? &slots[index] : nullptr;
+    }
+
+    const PriceLevel* find(Price price) const {
+        size_t index = 0;
+        if (!indexOf(price, index)) {
+            return findOverflow(price);
+        }
+        return isOccupied(index) ? &slots[index] : nullptr;
+    }
+
+    void erase(Price price) {
+        size_t index = 0;
+        if (!indexOf(price, index)) {
+            overflow.erase(price);
+            return;
+        }
+        if (!isOccupied(index)) {
+            return;
+        }
+
+        slots[index].clear();
+        unmark(index);
+        levelCount--;
+
+        if (index == bestIndex && levelCount > 0) {
+            bestIndex = nextInPriority(index);
+        }
+    }
+
+    void clear() {
+        for (size_t index = scanUp(0); index != NPOS; index = scanUp(index + 1)) {
+            slots[index].clear();
+        }
+        std::fill(occupied.begin(), occupied.end(), 0);
+        levelCount = 0;
+        bestIndex = 0;
+        overflow.clear();
+    }
+
+    /**
+     * Visits levels from best to worst until the visitor returns false
+     * @param visit Callable as bool(Price, const PriceLevel&)
+     */
+    template<typename Visitor>
+    void forEach(Visitor&& visit) const {
+        // Overflow levels rank either before the whole window or after it
+        auto it = overflow.begin();
+        for (; it != overflow.end() && ranksBeforeWindow(it->first); ++it) {
+            if (!visit(it->first, it->second)) return;
+        }
+        if (levelCount > 0) {
+            for (size_t index = bestIndex; index != NPOS; index = nextInPriority(index)) {
+                if (!visit(Price(baseTick + static_cast<int64_t>(index)), slots[index])) return;
+            }
+        }
+        for (; it != overflow.end(); ++it) {
+            if (!visit(it->first, it->second)) return;
+        }
+    }
+
+private:
+    static constexpr size_t WORD_BITS = 64;
+    static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+    // Bids rank higher prices first, asks rank lower prices first
+    static constexpr bool DESCENDING = Compare{}(Price(1), Price(0));
+
+    std::vector<PriceLevel> slots;
+    std::vector<uint64_t> occupied;
+    int64_t baseTick = 0;
+    size_t bestIndex = 0;
+    size_t levelCount = 0;    // Occupied slots, not counting overflow
+
+    // Levels outside the window, never at a price the window covers
+    std::map<Price, PriceLevel, Compare> overflow;
+
+    // Outside the window on its better side, so ahead of every slot
+    bool ranksBeforeWindow(Price price) const {
+        return DESCENDING ? price.ticks >= baseTick + static_cast<int64_t>(slots.size()) : price.ticks < baseTick;
+    }
+
+    bool overflowLeads() const {
+        return !overflow.empty() && (levelCount == 0 || ranksBeforeWindow(overflow.begin()->first));
+    }
+
+    PriceLevel* findOverflow(Price price) {
+        auto it = overflow.find(price);
+        return it == overflow.end() ? nullptr : &it->second;
+    }
+
+    const PriceLevel* findOverflow(Price price) const {
+        auto it = overflow.find(price);
+        return it == overflow.end() ? nullptr : &it->second;
+    }
+
+    bool indexOf(Price price, size_t& index) const {
+        int64_t offset = price.ticks - baseTick;
+        if (offset < 0 || offset >= static_cast<int64_t>(slots.size())) {
+            return false;
+        }
+        index = static_cast<size_t>(offset);
+        return true;
+    }
+
+    bool isOccupied(size_t index) const {
+        return (occupied[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+    }
+
+    void mark(size_t index) { occupied[index / WORD_BITS] |= uint64_t{1} << (index % WORD_BITS); }
+    void unmark(size_t index) { occupied[index / WORD_BITS] &= ~(uint64_t{1} << (index % WORD_BITS)); }
+
+    static bool ranksBefore(size_t lhs, size_t rhs) {
+        return DESCENDING ? lhs > rhs : lhs < rhs;
+    }
+
+    // First occupied index >= start, or NPOS
+    size_t scanUp(size_t start) const {
+        if (start >= slots.size()) return NPOS;
+        size_t word = start / WORD_BITS;
+        uint64_t bits = occupied[word] & (~uint64_t{0} << (start % WORD_BITS));
+        while (bits == 0) {
+            if (++word == occupied.size()) return NPOS;
+            bits = occupied[word];
+        }
+        return word * WORD_BITS + lowest_set_bit(bits);
+    }
+
+    // Last occupied index <= start, or NPOS
+    size_t scanDown(size_t start) const {
+        if (start == NPOS) return NPOS;
+        size_t word = start / WORD_BITS;
+        size_t bit = start % WORD_BITS;
+        uint64_t bits = occupied[word] & (bit == WORD_BITS - 1 ? ~uint64_t{0} : (uint64_t{1} << (bit + 1)) - 1);
+        while (bits == 0) {
+            if (word == 0) return NPOS;
+            bits = occupied[--word];
+        }
+        return word * WORD_BITS + highest_set_bit(bits);
+    }
+
+    // Next occupied index after `index` in priority order, or NPOS
+    size_t nextInPriority(size_t index) const {
+        if (DESCENDING) {
+            return index == 0 ? NPOS : scanDown(index - 1);
+        }
+        return scanUp(index + 1);
+    }
+
+    /**
+     * Moves the window so that every occupied level and the given price fit,
+     * centered on the middle of that range with room to drift either way.
+     * Overflow levels the new window covers move into it.
+     * @return false, leaving the window as it was, if they cannot fit in MAX_CAPACITY
+     */
+    bool recenter(Price price) {
+        int64_t low = price.ticks;
+        int64_t high = price.ticks;
+
+        if (levelCount > 0) {
+            low = std::min(low, baseTick + static_cast<int64_t>(scanUp(0)));
+            high = std::max(high, baseTick + static_cast<int64_t>(scanDown(slots.size() - 1)));
+        }
+
+        // Centering needs one slot more than the range itself
+        int64_t span = high - low + 1;
+        size_t newCapacity = slots.size();
+        while (static_cast<int64_t>(newCapacity) < 2 * span && newCapacity < MAX_CAPACITY) {
+            newCapacity *= 2;
+        }
+        if (static_cast<int64_t>(newCapacity) <= span) {
+            return false;
+        }
+
+        int64_t newBase = low + (high - low) / 2 - static_cast<int64_t>(newCapacity / 2);
+
+        std::vector<PriceLevel> newSlots(newCapacity);
+        std::vector<uint64_t> newOccupied(newCapacity / WORD_BITS, 0);
+
+        for (size_t index = scanUp(0); index != NPOS; index = scanUp(index + 1)) {
+            size_t moved = static_cast<size_t>(baseTick + static_cast<int64_t>(index) - newBase);
+            newSlots[moved] = slots[index];
+            newOccupied[moved / WORD_BITS] |= uint64_t{1} << (moved % WORD_BITS);
+        }
+
+        slots = std::move(newSlots);
+        occupied = std::move(newOccupied);
+        baseTick = newBase;
+
+        for (auto it = overflow.begin(); it != overflow.end();) {
+            size_t index = 0;
+            if (indexOf(it->first, index)) {
+                slots[index] = it->second;
+                mark(index);
+                levelCount++;
+                it = overflow.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        if (levelCount > 0) {
+            bestIndex = DESCENDING ? scanDown(slots.size() - 1) : scanUp(0);
+        }
+        return true;
+    }
+};
+
+} // namespace velocore
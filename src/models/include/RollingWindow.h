@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Trade.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <crow/json.h>
+
+namespace velocore {
+
+/**
+ * WindowSummary - Trades over one rolling window.
+ * Prices are zero ticks and vwap zero when the window holds no trades.
+ */
+struct WindowSummary {
+    std::chrono::nanoseconds length{0};
+    std::chrono::nanoseconds covered{0};    // History the window actually holds, see trades_per_second
+    uint64_t trades = 0;
+    int64_t volume = 0;
+    double vwap_ticks = 0.0;    // Volume-weighted average price, in ticks
+    Price open;
+    Price high;
+    Price low;
+    Price close;
+
+    /**
+     * Averages over the covered span rather than the nominal length, so the
+     * rate isn't understated while the window is still filling after startup
+     * or a clear; the span is at least one bucket wide
+     */
+    double trades_per_second() const;
+    crow::json::wvalue to_json(double tickSize) const;
+};
+
+/**
+ * RollingWindow - VWAP, OHLCV and trade count over the last length of time.
+ *
+ * The window is cut into BUCKET_COUNT buckets in a circular array. A trade
+ * is folded into the bucket for its timestamp, and a bucket is recycled the
+ * first time a trade lands in it after the window has moved past it, so
+ * memory is fixed however many trades arrive. A query merges the buckets
+ * still inside the window, a fixed amount of work independent of the trade
+ * count. The oldest bucket is counted whole, so the window covers between
+ * length - length / BUCKET_COUNT and length of history.
+ */
+class RollingWindow {
+public:
+    static constexpr size_t BUCKET_COUNT = 100;
+
+    /**
+     * @param length Span of the window, a multiple of BUCKET_COUNT nanoseconds
+     * @throws std::invalid_argument if length is not positive
+     */
+    explicit RollingWindow(std::chrono::nanoseconds length);
+
+    /**
+     * Folds a trade into the bucket for its timestamp
+     * Trades older than the window are ignored
+     * @note NOT thread-safe - the owning book calls this under its exclusive lock
+     */
+    void add(const Trade& trade);
+
+    /**
+     * Merges the buckets inside the window ending at now
+     * @note NOT thread-safe - caller must hold at least a shared lock
+     */
+    WindowSummary summary(std::chrono::steady_clock::time_point now) const;
+
+    void clear();
+
+    std::chrono::nanoseconds length() const { return bucketWidth * BUCKET_COUNT; }
+
+private:
+    struct Bucket {
+        int64_t index = -1;    // Bucket number since the clock's epoch, -1 if unused
+        uint64_t trades = 0;
+        int64_t volume = 0;
+        int64_t notional = 0;  // Sum of price ticks * quantity
+        Price open;
+        Price high;
+        Price low;
+        Price close;
+    };
+
+    std::chrono::nanoseconds bucketWidth;
+    std::array<Bucket, BUCKET_COUNT> buckets;
+    int64_t firstIndex = -1;    // Bucket of the earliest trade since construction or clear, -1 if none
+
+    int64_t bucketIndex(std::chrono::steady_clock::time_point time) const;
+};
+
+/**
+ * TradeAnalytics - The 1 second, 1 minute and 5 minute windows of one book.
+ */
+class TradeAnalytics {
+public:
+    static constexpr size_t WINDOW_COUNT = 3;
+
+    TradeAnalytics();
+
+    /**
+     * @note NOT thread-safe - the owning book calls this under its exclusive lock
+     */
+    void add(const Trade& trade);
+
+    /**
+     * @param window 0 for 1 second, 1 for 1 minute, 2 for 5 minutes
+     * @note NOT thread-safe - caller must hold at least a shared lock
+     */
+    WindowSummary summary(size_t window, std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * Renders every window, keyed "1s", "1m" and "5m"
+     * @note NOT thread-safe - caller must hold at least a shared lock
+     */
+    crow::json::wvalue to_json(double tickSize, std::chrono::steady_clock::time_point now) const;
+
+    void clear();
+
+private:
+    std::array<RollingWindow, WINDOW_COUNT> windows;
+};
+
+} // namespace velocore
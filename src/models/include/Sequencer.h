@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Exchange.h"
+#include "MpscQueue.h"
+#include <atomic>
+#include <future>
+#include <optional>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace velocore {
+
+/**
+ * Sequencer - Single-writer front end for an Exchange.
+ *
+ * Request threads push order and cancel commands into a bounded lock-free
+ * queue and wait on a future. One matching thread drains the queue and is
+ * the only writer to every book, so commands execute in one deterministic
+ * sequence and writers never hand the book mutex to each other. The book
+ * locks are still taken, uncontended, so readers can keep using the
+ * shared-lock query methods concurrently.
+ */
+class Sequencer {
+public:
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 65536;
+
+    /**
+     * @param exchange The exchange whose books this sequencer writes to
+     * @param queueCapacity Maximum commands waiting to be matched
+     */
+    explicit Sequencer(Exchange& exchange, size_t queueCapacity = DEFAULT_QUEUE_CAPACITY);
+
+    /**
+     * Destructor - stops the matching thread after draining queued commands
+     */
+    ~Sequencer();
+
+    Sequencer(const Sequencer&) = delete;
+    Sequencer& operator=(const Sequencer&) = delete;
+
+    /**
+     * Starts the matching thread
+     * @param cpu Core to pin the matching thread to, or -1 to leave it unpinned
+     */
+    void start(int cpu = -1);
+
+    /**
+     * Executes everything already queued, then joins the matching thread
+     * Commands submitted from now on are rejected, see submitOrder()
+     */
+    void stop();
+
+    bool isRunning() const { return running; }
+
+    /**
+     * Queues a new order for matching
+     * Spins while the queue is full, which applies backpressure to callers
+     * @param order The order to add/match
+     * @return Future resolved with the trades the order generated. Before start()
+     *         or after stop() nothing would execute it, so the future holds a
+     *         std::runtime_error instead; the same goes for every submit method.
+     * @note Thread-safe for any number of callers
+     */
+    std::future<std::vector<Trade>> submitOrder(const Order& order);
+    
+    /**
+     * Queues a batch of orders as one command, matched back to back
+     * @param orders Orders to add/match, in arrival order
+     * @return Future resolved with the trades of each order, parallel to orders
+     * @note Thread-safe for any number of callers
+     */
+    std::future<std::vector<std::vector<Trade>>> submitOrders(std::vector<Order> orders);
+
+    /**
+     * Queues a cancel
+     * @param orderId The ID of the order to cancel
+     * @param symbol The order's symbol, or empty to search every book
+     * @return Future resolved with whether the order was cancelled
+     * @note Thread-safe for any number of callers
+     */
+    std::future<bool> submitCancel(uint64_t orderId, SymbolId symbol = SymbolId());
+
+    /**
+     * Queues an amend of a resting order
+     * @param symbol The order's symbol
+     * @param orderId The ID of the order to amend
+     * @param newPrice The new limit price
+     * @param newQuantity The new total quantity
+     * @return Future resolved with the amended order's trades, or std::nullopt if not found
+     * @note Thread-safe for any number of callers
+     */
+    std::future<std::optional<std::vector<Trade>>> submitAmend(SymbolId symbol, uint64_t orderId,
+                                                               Price newPrice, int newQuantity);
+    
+    /**
+     * Gets the number of commands the matching thread has executed
+     */
+    uint64_t getProcessedCount() const { return processed.load(std::memory_order_relaxed); }
+
+private:
+    struct NewOrderCommand {
+        Order order;
+        std::promise<std::vector<Trade>> result;
+    };
+
+    struct BatchCommand {
+        std::vector<Order> orders;
+        std::promise<std::vector<std::vector<Trade>>> result;
+    };
+    
+    struct AmendCommand {
+        SymbolId symbol;
+        uint64_t orderId;
+        Price newPrice;
+        int newQuantity;
+        std::promise<std::optional<std::vector<Trade>>> result;
+    };
+    
+    struct CancelCommand {
+        uint64_t orderId;
+        SymbolId symbol;
+        std::promise<bool> result;
+    };
+
+    using Command = std::variant<std::monostate, NewOrderCommand, BatchCommand, AmendCommand, CancelCommand>;
+
+    Exchange& exchange;
+    MpscQueue<Command> queue;
+    std::thread matchingThread;
+    std::atomic<bool> running{false};
+    std::atomic<int> pushing{0};    // Callers between checking running and queueing
+    std::atomic<uint64_t> processed{0};
+
+    void push(Command&& command);
+    void run();
+    void execute(Command& command);
+    static void pinToCpu(std::thread& thread, int cpu);
+};
+
+} // namespace velocore
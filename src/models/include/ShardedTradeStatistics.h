@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Trade.h"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <crow/json.h>
+
+namespace velocore {
+
+/**
+ * ShardedTradeStatistics - TradeStatistics that any number of threads can
+ * update at once without locks.
+ *
+ * Each thread is given one of SHARD_COUNT cache-line-sized shards the
+ * first time it records a trade, and only touches that shard afterwards,
+ * so concurrent updates don't contend. Readers merge every shard into a
+ * TradeStatistics snapshot. Each total is exact. A trade's count is
+ * published after its other fields, so every trade included in a count read
+ * by tradeCount() is fully visible to a snapshot taken afterwards; a read that
+ * races an update may still see a trade not yet counted partly applied.
+ */
+class ShardedTradeStatistics {
+public:
+    static constexpr size_t SHARD_COUNT = 64;
+
+    ShardedTradeStatistics() = default;
+
+    ShardedTradeStatistics(const ShardedTradeStatistics&) = delete;
+    ShardedTradeStatistics& operator=(const ShardedTradeStatistics&) = delete;
+
+    /**
+     * Records a trade in the calling thread's shard
+     * @note Thread-safe - lock-free
+     */
+    void update(const Trade& trade);
+
+    /**
+     * Merges every shard
+     * @return Totals over all trades recorded so far
+     * @note Thread-safe - lock-free, never blocks updaters
+     */
+    TradeStatistics snapshot() const;
+
+    crow::json::wvalue to_json() const { return snapshot().to_json(); }
+
+    /**
+     * @return Trades recorded so far, cheaper than a full snapshot; safe to
+     *         version a snapshot taken after it
+     * @note Thread-safe - lock-free
+     */
+    uint64_t tradeCount() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> trades{0};
+        std::atomic<uint64_t> volume{0};
+        std::atomic<double> value{0.0};
+        std::atomic<double> minPrice{std::numeric_limits<double>::max()};
+        std::atomic<double> maxPrice{std::numeric_limits<double>::lowest()};
+        std::atomic<int64_t> lastTradeNanos{0};
+    };
+
+    Shard shards[SHARD_COUNT];
+
+    static size_t shardIndex();
+};
+
+} // namespace velocore
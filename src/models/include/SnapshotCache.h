@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Symbol.h"
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace velocore {
+
+/**
+ * What a cached response was built from. A response is only reused while
+ * every component still has the value it was built at.
+ */
+struct SnapshotVersion {
+    uint64_t book = 0;      // OrderBook::getVersion()
+    uint64_t trades = 0;    // Trade count of any exchange-wide statistics in the response
+};
+
+constexpr bool operator==(SnapshotVersion lhs, SnapshotVersion rhs) {
+    return lhs.book == rhs.book && lhs.trades == rhs.trades;
+}
+
+/**
+ * Identifies one response: the book it shows and the route and parameters,
+ * encoded by the caller as view
+ */
+struct SnapshotKey {
+    SymbolId symbol;
+    uint32_t view = 0;
+};
+
+constexpr bool operator==(SnapshotKey lhs, SnapshotKey rhs) {
+    return lhs.symbol == rhs.symbol && lhs.view == rhs.view;
+}
+
+struct SnapshotKeyHash {
+    size_t operator()(SnapshotKey key) const noexcept {
+        return (static_cast<size_t>(key.symbol.value) << 32) ^ key.view;
+    }
+};
+
+/**
+ * CachedSnapshot - A serialized response and the ETag that names it.
+ * Immutable once stored, so readers share it without copying or locking.
+ */
+struct CachedSnapshot {
+    SnapshotVersion version;
+    std::string body;
+    std::string etag;
+};
+
+/**
+ * SnapshotCache - Serialized book responses, reused until the book changes.
+ *
+ * Callers read the version before serializing and store the body under
+ * that version. A body built while a write lands may already show the
+ * write, but it is then stored under the old version, which no longer
+ * matches, so a stale body is never served. There is one entry per key,
+ * so memory is bounded by symbols times views.
+ */
+class SnapshotCache {
+public:
+    SnapshotCache();
+
+    SnapshotCache(const SnapshotCache&) = delete;
+    SnapshotCache& operator=(const SnapshotCache&) = delete;
+
+    /**
+     * @return The cached response for key if it was built at version, else nullptr
+     * @note Thread-safe - acquires shared lock
+     */
+    std::shared_ptr<const CachedSnapshot> find(SnapshotKey key, SnapshotVersion version) const;
+
+    /**
+     * Caches a response, replacing whatever key held
+     * @return The stored entry, with its ETag filled in
+     * @note Thread-safe - acquires exclusive lock
+     */
+    std::shared_ptr<const CachedSnapshot> store(SnapshotKey key, SnapshotVersion version, std::string body);
+
+    /**
+     * Checks an If-None-Match header against an ETag
+     * @param ifNoneMatch The header value, a list of ETags or "*"
+     */
+    static bool matches(std::string_view ifNoneMatch, std::string_view etag);
+
+private:
+    // Distinguishes ETags from earlier runs, whose versions restarted at 0
+    uint64_t instanceTag;
+
+    std::unordered_map<SnapshotKey, std::shared_ptr<const CachedSnapshot>, SnapshotKeyHash> entries;
+    mutable std::shared_mutex entriesMutex;
+};
+
+} // namespace velocore
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace velocore {
+
+/**
+ * SymbolId - Dense integer handle for an interned ticker.
+ *
+ * Tickers are interned once where they enter the system (REST requests and
+ * the market data feed), so orders, trades and ticks carry a 4-byte id that
+ * copies, compares and hashes as an integer. The ticker string is only
+ * looked up again when producing output. Ids are assigned from 1 in order of
+ * first use and are never reused; the default id is the empty symbol.
+ */
+struct SymbolId {
+    uint32_t value = 0;
+
+    constexpr SymbolId() = default;
+    constexpr explicit SymbolId(uint32_t value) : value(value) {}
+
+    constexpr bool empty() const { return value == 0; }
+};
+
+constexpr bool operator==(SymbolId lhs, SymbolId rhs) { return lhs.value == rhs.value; }
+constexpr bool operator!=(SymbolId lhs, SymbolId rhs) { return lhs.value != rhs.value; }
+constexpr bool operator<(SymbolId lhs, SymbolId rhs) { return lhs.value < rhs.value; }
+
+/**
+ * Gets the id of a ticker, assigning the next one on first use
+ * @param symbol The ticker, empty maps to the empty SymbolId
+ * @note Thread-safe - acquires shared lock, exclusive only for a new ticker
+ */
+SymbolId intern_symbol(const std::string& symbol);
+
+/**
+ * Gets the id of a ticker without interning it
+ * @return The ticker's id, or the empty SymbolId if it was never interned
+ * @note Thread-safe - acquires shared lock
+ */
+SymbolId find_symbol(const std::string& symbol);
+
+/**
+ * Gets the ticker an id was interned from
+ * @return The ticker, valid for the life of the process; empty for unknown ids
+ * @note Thread-safe - acquires shared lock
+ */
+const std::string& symbol_name(SymbolId id);
+
+inline std::ostream& operator<<(std::ostream& out, SymbolId id) {
+    return out << symbol_name(id);
+}
+
+} // namespace velocore
+
+namespace std {
+
+template<>
+struct hash<velocore::SymbolId> {
+    size_t operator()(velocore::SymbolId id) const noexcept { return id.value; }
+};
+
+} // namespace std
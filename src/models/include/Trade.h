@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Price.h"
+#include "Symbol.h"
+#include "JsonWriter.h"
 #include <atomic>
 #include <chrono>
 #include <string>
@@ -8,19 +11,43 @@
 
 namespace velocore {
 
+/**
+ * Trade ids assigned by an order book hold the book's SymbolId in the top
+ * bits and the book's trade sequence number, counting up from 1 without
+ * gaps, in the low TRADE_SEQUENCE_BITS bits. They are unique across books,
+ * and a consumer of one book's trades can spot a lost one from a gap in the
+ * sequence.
+ */
+constexpr int TRADE_SEQUENCE_BITS = 40;
+
+constexpr uint64_t make_trade_id(SymbolId symbol, uint64_t sequence) {
+    return (static_cast<uint64_t>(symbol.value) << TRADE_SEQUENCE_BITS) | sequence;
+}
+
+constexpr uint64_t trade_sequence(uint64_t trade_id) {
+    return trade_id & ((uint64_t(1) << TRADE_SEQUENCE_BITS) - 1);
+}
+
+constexpr SymbolId trade_symbol(uint64_t trade_id) {
+    return SymbolId(static_cast<uint32_t>(trade_id >> TRADE_SEQUENCE_BITS));
+}
+
 struct Trade {
     uint64_t trade_id;
     uint64_t buy_order_id;
     uint64_t sell_order_id;
-    std::string symbol;
-    double price;
+    SymbolId symbol;
+    Price price;
     int quantity;
     std::chrono::steady_clock::time_point timestamp;
     
     Trade() = default;
     
-    Trade(uint64_t buy_order_id, uint64_t sell_order_id, const std::string& symbol, 
-          double price, int quantity);
+    Trade(uint64_t buy_order_id, uint64_t sell_order_id, SymbolId symbol, 
+          Price price, int quantity);
+    
+    Trade(uint64_t trade_id, uint64_t buy_order_id, uint64_t sell_order_id, SymbolId symbol,
+          Price price, int quantity);
     
     static uint64_t generate_id();
     
@@ -28,9 +55,14 @@ private:
     static std::atomic<uint64_t> id_counter;
     
 public:
+    double price_value() const;
     double total_value() const;
     
     crow::json::wvalue to_json() const;
+    
+    // Writes the to_json fields straight into writer, for responses listing many trades
+    void write_json(JsonWriter& writer) const;
+    
     static Trade from_json(const crow::json::rvalue& json);
 };
 
@@ -49,6 +81,7 @@ struct TradeStatistics {
     
     void update(const Trade& trade);
     crow::json::wvalue to_json() const;
+    void write_json(JsonWriter& writer) const;
 };
 
 } 
\ No newline at end of file
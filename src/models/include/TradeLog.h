@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Trade.h"
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace velocore {
+
+/**
+ * TradeLog - Fixed-capacity ring of the most recent trades.
+ *
+ * Memory stays bounded however long the book runs: once the ring is full,
+ * each new trade evicts the oldest one. If a spill file is configured, the
+ * evicted trade is handed to a background writer that appends it as a
+ * fixed-size binary record (see SpillRecord), so the full history is still
+ * kept on disk without file I/O on the matching path.
+ * Readers iterate the ring in place, oldest first, instead of copying it.
+ */
+class TradeLog {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 65536;
+
+    /**
+     * On-disk layout of one spilled trade, 64 bytes
+     * Symbols are stored as text, since SymbolIds only hold within one process,
+     * and those longer than SYMBOL_BYTES - 1 characters are truncated
+     */
+    static constexpr size_t SYMBOL_BYTES = 20;
+    struct SpillRecord {
+        uint64_t trade_id;
+        uint64_t buy_order_id;
+        uint64_t sell_order_id;
+        int64_t price_ticks;
+        int64_t timestamp_ns;      // Wall-clock nanoseconds since the Unix epoch, 0 if never set
+        int32_t quantity;
+        char symbol[SYMBOL_BYTES];  // NUL-terminated ticker
+    };
+    static_assert(sizeof(SpillRecord) == 64, "SpillRecord layout must stay fixed");
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Trade;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Trade*;
+        using reference = const Trade&;
+
+        const_iterator(const TradeLog* log, size_t position) : log(log), position(position) {}
+        reference operator*() const { return (*log)[position]; }
+        pointer operator->() const { return &(*log)[position]; }
+        const_iterator& operator++() { ++position; return *this; }
+        bool operator==(const const_iterator& other) const { return position == other.position; }
+        bool operator!=(const const_iterator& other) const { return position != other.position; }
+
+    private:
+        const TradeLog* log;
+        size_t position;
+    };
+
+    /**
+     * @param capacity Trades kept in memory
+     * @param spillPath File evicted trades are appended to, or empty to drop them
+     * @throws std::runtime_error if the spill file cannot be opened
+     */
+    explicit TradeLog(size_t capacity = DEFAULT_CAPACITY, const std::string& spillPath = "");
+
+    /**
+     * Writes out every trade still waiting to be spilled
+     */
+    ~TradeLog();
+
+    TradeLog(const TradeLog&) = delete;
+    TradeLog& operator=(const TradeLog&) = delete;
+
+    /**
+     * Records a trade, evicting (and spilling) the oldest one if the ring is full
+     */
+    void append(const Trade& trade);
+
+    /**
+     * Gets a trade held in memory
+     * @param position 0 is the oldest trade still in memory
+     */
+    const Trade& operator[](size_t position) const {
+        return ring[(head + position) % ring.size()];
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    bool empty() const { return ring.empty(); }
+    const Trade& back() const { return (*this)[size() - 1]; }
+
+    // Trades currently held in memory
+    size_t size() const { return ring.size(); }
+    size_t capacity() const { return ringCapacity; }
+
+    // Trades ever appended, including evicted ones
+    uint64_t totalCount() const { return appended; }
+
+    // Trades evicted from memory, whether or not they were spilled
+    uint64_t evictedCount() const { return appended - ring.size(); }
+
+    /**
+     * Finds the first in-memory position whose trade id is at least tradeId
+     * Trade ids only increase, so this is a direct index when the ids in
+     * memory are consecutive and a binary search otherwise
+     * @return Position in [0, size()]
+     */
+    size_t lowerBound(uint64_t tradeId) const;
+
+    /**
+     * Finds the first in-memory position whose trade is ordered after the
+     * given one by time, then id (see operator< on Trade)
+     * @return Position in [0, size()]
+     */
+    size_t upperBound(const Trade& trade) const;
+
+    /**
+     * Looks up an in-memory trade by id
+     * @return The trade, or nullptr if it was never recorded or has been evicted
+     */
+    const Trade* find(uint64_t tradeId) const;
+
+    /**
+     * Drops every trade held in memory; already spilled trades stay on disk
+     */
+    void clear();
+
+    /**
+     * Reads back every trade in a spill file
+     * @param path File written by a TradeLog
+     * @return Trades in the order they were evicted
+     */
+    static std::vector<Trade> readSpillFile(const std::string& path);
+
+private:
+    std::vector<Trade> ring;
+    size_t ringCapacity;
+    size_t head;
+    uint64_t appended;
+
+    // Evicted trades waiting for the writer; they keep their SymbolId, and
+    // the writer resolves it to text off the matching path
+    std::mutex spillMutex;
+    std::condition_variable spillCondition;
+    std::vector<Trade> pendingSpill;
+    bool spillStopping = false;
+    std::ofstream spillFile;    // Background thread only once it has started
+    std::thread spillWorker;
+
+    void spill(const Trade& trade);
+
+    /**
+     * Writes pending trades to the spill file until the log is destroyed
+     * @note Background thread only
+     */
+    void runSpill();
+};
+
+} // namespace velocore
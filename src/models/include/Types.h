@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Clock.h"
+#include "Symbol.h"
+#include "JsonWriter.h"
 #include <string>
 #include <chrono>
 #include <crow/json.h>
@@ -32,7 +35,7 @@ enum class MarketDataType {
 
 // Market tick structure for real-time market data
 struct MarketTick {
-    std::string symbol;
+    SymbolId symbol;
     MarketDataType type;
     std::chrono::steady_clock::time_point timestamp;
     
@@ -55,10 +58,13 @@ struct MarketTick {
     
     MarketTick() = default;
     
-    MarketTick(const std::string& sym, MarketDataType t) 
-        : symbol(sym), type(t), timestamp(std::chrono::steady_clock::now()) {}
+    MarketTick(SymbolId sym, MarketDataType t) 
+        : symbol(sym), type(t), timestamp(Clock::now()) {}
     
     crow::json::wvalue to_json() const;
+    
+    // Same fields as to_json, streamed without building a wvalue
+    void write_json(JsonWriter& writer) const;
 };
 
 // Market data subscription info
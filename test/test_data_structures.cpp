@@ -1,12 +1,70 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
+#include <random>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <iostream>
+#include <set>
 #include "../src/models/include/Order.h"
 #include "../src/models/include/Trade.h"
 #include "../src/models/include/OrderBook.h"
+#include "../src/models/include/Exchange.h"
+#include "../src/models/include/MpscQueue.h"
+#include "../src/models/include/Sequencer.h"
+#include "../src/models/include/SeqLock.h"
+#include "../src/models/include/TradeLog.h"
 #include "../src/models/include/Types.h"
+#include "../src/models/include/Price.h"
+#include "../src/models/include/Clock.h"
+#include "../src/models/include/ShardedTradeStatistics.h"
+#include "../src/models/include/RollingWindow.h"
+#include "../src/models/include/LatencyHistogram.h"
+#include "../src/models/include/Logger.h"
+#include "../src/models/include/JsonWriter.h"
+#include "../src/models/include/SnapshotCache.h"
+#include "../src/models/include/OrderEntryProtocol.h"
+#include "../src/OrderEntryGateway.h"
+#include "../src/OrderEntryClient.h"
+#include <boost/asio/write.hpp>
 
 using namespace velocore;
+
+// Global allocation counter, only counts while a test switches it on
+namespace {
+std::atomic<bool> countAllocations{false};
+std::atomic<size_t> allocationCount{0};
+}
+
+// Kept out of line so the compiler does not pair inlined free() calls with operator new
+#if defined(__GNUC__)
+#define VELOCORE_TEST_NOINLINE __attribute__((noinline))
+#else
+#define VELOCORE_TEST_NOINLINE
+#endif
+
+VELOCORE_TEST_NOINLINE void* operator new(size_t size) {
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+VELOCORE_TEST_NOINLINE void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+VELOCORE_TEST_NOINLINE void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
 class DataModelsTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -19,22 +77,67 @@ protected:
 TEST_F(DataModelsTest, OrderStructureTest) {
     Order order;
     order.id = 12345;
-    order.symbol = "TEST";
+    order.symbol = intern_symbol("TEST");
     order.side = Side::Buy;
     order.type = OrderType::Limit;
-    order.price = 100.50;
+    order.price = Price::from_double(100.50);
     order.quantity = 100;
     order.timestamp = test_time;
     
     EXPECT_EQ(order.id, 12345);
-    EXPECT_EQ(order.symbol, "TEST");
+    EXPECT_EQ(symbol_name(order.symbol), "TEST");
     EXPECT_EQ(order.side, Side::Buy);
     EXPECT_EQ(order.type, OrderType::Limit);
-    EXPECT_DOUBLE_EQ(order.price, 100.50);
+    EXPECT_EQ(order.price, Price::from_double(100.50));
+    EXPECT_DOUBLE_EQ(order.price.to_double(), 100.50);
     EXPECT_EQ(order.quantity, 100);
     EXPECT_EQ(order.timestamp, test_time);
 }
 
+TEST_F(DataModelsTest, OrderIdBlocksTest) {
+    // Threads draw ids from their own blocks, and no two ids ever collide
+    constexpr int THREADS = 4;
+    constexpr int IDS_PER_THREAD = 3000;
+    std::vector<std::vector<uint64_t>> ids(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&ids, t]() {
+            for (int i = 0; i < IDS_PER_THREAD; ++i) {
+                ids[t].push_back(Order::generate_id());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    std::vector<uint64_t> all;
+    for (const auto& threadIds : ids) {
+        EXPECT_TRUE(std::is_sorted(threadIds.begin(), threadIds.end()));
+        all.insert(all.end(), threadIds.begin(), threadIds.end());
+    }
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+}
+
+TEST_F(DataModelsTest, ClockTest) {
+    // Stays on the steady_clock timeline and never runs backwards
+    Clock::now();  // The first call calibrates
+    auto steadyBefore = std::chrono::steady_clock::now();
+    auto first = Clock::now();
+    auto second = Clock::now();
+    auto steadyAfter = std::chrono::steady_clock::now();
+    EXPECT_LE(first, second);
+    EXPECT_LT(std::chrono::abs(first - steadyBefore), std::chrono::milliseconds(5));
+    EXPECT_LT(std::chrono::abs(second - steadyAfter), std::chrono::milliseconds(5));
+    
+    // Serialized as wall time
+    int64_t wallMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    EXPECT_LT(std::abs(Clock::toUnixMillis(Clock::now()) - wallMillis), 1000);
+    EXPECT_EQ(Clock::toUnixMillis(Clock::time_point{}), 0);
+}
+
 TEST_F(DataModelsTest, SideEnumTest) {
     Order buyOrder;
     buyOrder.side = Side::Buy;
@@ -64,20 +167,125 @@ TEST_F(DataModelsTest, TradeStructureTest) {
     trade.trade_id = 67890;
     trade.buy_order_id = 12345;
     trade.sell_order_id = 54321;
-    trade.symbol = "TEST";
-    trade.price = 100.75;
+    trade.symbol = intern_symbol("TEST");
+    trade.price = Price::from_double(100.75);
     trade.quantity = 50;
     trade.timestamp = test_time;
     
     EXPECT_EQ(trade.trade_id, 67890);
     EXPECT_EQ(trade.buy_order_id, 12345);
     EXPECT_EQ(trade.sell_order_id, 54321);
-    EXPECT_EQ(trade.symbol, "TEST");
-    EXPECT_DOUBLE_EQ(trade.price, 100.75);
+    EXPECT_EQ(symbol_name(trade.symbol), "TEST");
+    EXPECT_DOUBLE_EQ(trade.price_value(), 100.75);
     EXPECT_EQ(trade.quantity, 50);
     EXPECT_EQ(trade.timestamp, test_time);
 }
 
+TEST_F(DataModelsTest, PriceTickConversionTest) {
+    // Values that differ as doubles must still land on the same tick
+    EXPECT_EQ(Price::from_double(0.1 + 0.2), Price::from_double(0.3));
+    EXPECT_EQ(Price::from_double(100.50).ticks, 10050);
+    EXPECT_EQ(Price::from_double(100.25, 0.25).ticks, 401);
+    EXPECT_DOUBLE_EQ(Price(401).to_double(0.25), 100.25);
+    
+    EXPECT_LT(Price::from_double(99.99), Price::from_double(100.00));
+    EXPECT_EQ(Price::from_double(101.00) - Price::from_double(100.50), Price(50));
+    
+    EXPECT_THROW(Price::from_double(100.0, 0.0), std::invalid_argument);
+}
+
+TEST_F(DataModelsTest, SymbolTickSizeTest) {
+    EXPECT_DOUBLE_EQ(tick_size_for("UNREGISTERED"), DEFAULT_TICK_SIZE);
+    
+    set_tick_size("TICKTEST", 0.05);
+    EXPECT_DOUBLE_EQ(tick_size_for("TICKTEST"), 0.05);
+    EXPECT_THROW(set_tick_size("TICKTEST", -1.0), std::invalid_argument);
+    
+    Trade trade(1, 2, intern_symbol("TICKTEST"), Price(2000), 10);
+    EXPECT_DOUBLE_EQ(trade.price_value(), 100.0);
+    EXPECT_DOUBLE_EQ(trade.total_value(), 1000.0);
+}
+
+TEST_F(DataModelsTest, SymbolInterningTest) {
+    SymbolId first = intern_symbol("INTERN");
+    EXPECT_FALSE(first.empty());
+    EXPECT_EQ(intern_symbol("INTERN"), first);
+    EXPECT_EQ(find_symbol("INTERN"), first);
+    EXPECT_EQ(symbol_name(first), "INTERN");
+    
+    // Lookups never grow the table; the empty ticker is the empty id
+    EXPECT_TRUE(find_symbol("NEVER_INTERNED").empty());
+    EXPECT_TRUE(intern_symbol("").empty());
+    EXPECT_EQ(symbol_name(SymbolId()), "");
+    
+    SymbolId second = intern_symbol("INTERN2");
+    EXPECT_NE(second, first);
+    EXPECT_EQ(symbol_name(first), "INTERN");
+}
+
+TEST_F(DataModelsTest, ShardedStatisticsTest) {
+    ShardedTradeStatistics stats;
+    EXPECT_EQ(stats.snapshot().total_trades, 0);
+    
+    const int threadCount = 8;
+    const int tradesPerThread = 1000;
+    SymbolId symbol = intern_symbol("TEST");
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < tradesPerThread; ++i) {
+                // Prices 100.00 to 100.07, one per thread
+                stats.update(Trade(1, 2, symbol, Price(10000 + t), 2));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    TradeStatistics merged = stats.snapshot();
+    EXPECT_EQ(merged.total_trades, threadCount * tradesPerThread);
+    EXPECT_EQ(merged.total_volume, threadCount * tradesPerThread * 2);
+    EXPECT_DOUBLE_EQ(merged.min_price, 100.00);
+    EXPECT_DOUBLE_EQ(merged.max_price, 100.07);
+    EXPECT_NEAR(merged.avg_price, 100.035, 1e-9);
+    EXPECT_NE(merged.last_trade_time, std::chrono::steady_clock::time_point{});
+}
+
+TEST_F(DataModelsTest, ShardedStatisticsCountPublishedLastTest) {
+    ShardedTradeStatistics stats;
+    SymbolId symbol = intern_symbol("TEST");
+    
+    // Every trade has quantity 1, so a snapshot taken after a count must hold at least that much volume
+    const int threadCount = 4;
+    const int tradesPerThread = 20000;
+    std::atomic<int> writersDone{0};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threadCount; ++t) {
+        writers.emplace_back([&]() {
+            for (int i = 0; i < tradesPerThread; ++i) {
+                stats.update(Trade(1, 2, symbol, Price(10000), 1));
+            }
+            writersDone++;
+        });
+    }
+    
+    while (writersDone.load() < threadCount) {
+        uint64_t count = stats.tradeCount();
+        TradeStatistics snapshot = stats.snapshot();
+        ASSERT_GE(static_cast<uint64_t>(snapshot.total_volume), count);
+        ASSERT_GE(static_cast<uint64_t>(snapshot.total_trades), count);
+        if (count > 0) {
+            ASSERT_DOUBLE_EQ(snapshot.min_price, 100.00);
+        }
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    
+    EXPECT_EQ(stats.tradeCount(), static_cast<uint64_t>(threadCount * tradesPerThread));
+}
+
 class MatchingEngineTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -88,10 +296,10 @@ protected:
     Order createOrder(Side side, OrderType type, double price, int quantity) {
         Order order;
         order.id = nextOrderId++;
-        order.symbol = "TEST";
+        order.symbol = intern_symbol("TEST");
         order.side = side;
         order.type = type;
-        order.price = price;
+        order.price = Price::from_double(price);
         order.quantity = quantity;
         order.remaining_quantity = quantity;
         order.status = OrderStatus::Active;
@@ -132,7 +340,26 @@ TEST_F(MatchingEngineTest, PriceTimePriorityTest) {
     EXPECT_EQ(trades[0].buy_order_id, firstOrder.id);
     EXPECT_EQ(trades[0].sell_order_id, sellOrder.id);
     EXPECT_EQ(trades[0].quantity, 30);
-    EXPECT_DOUBLE_EQ(trades[0].price, 100.0);
+    EXPECT_EQ(trades[0].price, Price::from_double(100.0));
+}
+
+TEST_F(MatchingEngineTest, SequencePriorityTest) {
+    // Identical timestamps - entry order alone decides who fills first
+    Order first = createOrder(Side::Buy, OrderType::Limit, 100.0, 10);
+    Order second = createOrder(Side::Buy, OrderType::Limit, 100.0, 10);
+    second.timestamp = first.timestamp;
+    orderBook->addOrder(second);
+    orderBook->addOrder(first);
+    
+    auto restingSecond = orderBook->findOrder(second.id);
+    auto restingFirst = orderBook->findOrder(first.id);
+    ASSERT_TRUE(restingSecond && restingFirst);
+    EXPECT_LT(restingSecond->sequence, restingFirst->sequence);
+    EXPECT_TRUE(*restingSecond < *restingFirst);
+    
+    std::vector<Trade> trades = orderBook->addOrder(createOrder(Side::Sell, OrderType::Limit, 100.0, 10));
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].buy_order_id, second.id);
 }
 
 TEST_F(MatchingEngineTest, PricePriorityTest) {
@@ -150,7 +377,7 @@ TEST_F(MatchingEngineTest, PricePriorityTest) {
     EXPECT_EQ(trades[0].buy_order_id, higherPriceBuy.id);
     EXPECT_EQ(trades[0].sell_order_id, sellOrder.id);
     EXPECT_EQ(trades[0].quantity, 50);
-    EXPECT_DOUBLE_EQ(trades[0].price, 101.0);
+    EXPECT_EQ(trades[0].price, Price::from_double(101.0));
 }
 
 TEST_F(MatchingEngineTest, PartialFillTest) {
@@ -162,7 +389,26 @@ TEST_F(MatchingEngineTest, PartialFillTest) {
     
     EXPECT_EQ(trades.size(), 1);
     EXPECT_EQ(trades[0].quantity, 40);
-    EXPECT_DOUBLE_EQ(trades[0].price, 100.0);
+    EXPECT_EQ(trades[0].price, Price::from_double(100.0));
+}
+
+TEST_F(MatchingEngineTest, RestingOrderDetailsTest) {
+    // The hot resting record stays within half a cache line
+    EXPECT_LE(sizeof(OrderNode), 32u);
+    
+    Order buyOrder = createOrder(Side::Buy, OrderType::Limit, 100.0, 100);
+    orderBook->addOrder(buyOrder);
+    orderBook->addOrder(createOrder(Side::Sell, OrderType::Limit, 100.0, 40));
+    
+    // Cold fields come back from the side table, live ones from the hot record
+    auto resting = orderBook->findOrder(buyOrder.id);
+    ASSERT_TRUE(resting.has_value());
+    EXPECT_EQ(symbol_name(resting->symbol), "TEST");
+    EXPECT_EQ(resting->side, Side::Buy);
+    EXPECT_EQ(resting->price, Price::from_double(100.0));
+    EXPECT_EQ(resting->quantity, 100);
+    EXPECT_EQ(resting->remaining_quantity, 60);
+    EXPECT_EQ(resting->status, OrderStatus::PartiallyFilled);
 }
 
 TEST_F(MatchingEngineTest, MarketOrderTest) {
@@ -174,7 +420,7 @@ TEST_F(MatchingEngineTest, MarketOrderTest) {
     
     EXPECT_EQ(trades.size(), 1);
     EXPECT_EQ(trades[0].quantity, 50);
-    EXPECT_DOUBLE_EQ(trades[0].price, 105.0);
+    EXPECT_EQ(trades[0].price, Price::from_double(105.0));
 }
 
 TEST_F(MatchingEngineTest, MultipleMatchesTest) {
@@ -247,6 +493,214 @@ TEST_F(MatchingEngineTest, QuantityConservationTest) {
     EXPECT_EQ(totalTradeQuantity, 75);
 }
 
+TEST_F(MatchingEngineTest, CancelOrderTest) {
+    Order buy1 = createOrder(Side::Buy, OrderType::Limit, 100.0, 10);
+    Order buy2 = createOrder(Side::Buy, OrderType::Limit, 100.0, 20);
+    Order buy3 = createOrder(Side::Buy, OrderType::Limit, 100.0, 30);
+    
+    orderBook->addOrder(buy1);
+    orderBook->addOrder(buy2);
+    orderBook->addOrder(buy3);
+    
+    // Cancel from the middle of the level
+    EXPECT_TRUE(orderBook->cancelOrder(buy2.id));
+    EXPECT_FALSE(orderBook->cancelOrder(buy2.id));
+    EXPECT_FALSE(orderBook->findOrder(buy2.id).has_value());
+    EXPECT_EQ(orderBook->getTotalOrders(), 2);
+    
+    // Remaining orders keep their time priority
+    Order sellOrder = createOrder(Side::Sell, OrderType::Limit, 100.0, 40);
+    std::vector<Trade> trades = orderBook->addOrder(sellOrder);
+    
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].buy_order_id, buy1.id);
+    EXPECT_EQ(trades[1].buy_order_id, buy3.id);
+    EXPECT_TRUE(orderBook->isEmpty());
+}
+
+TEST_F(MatchingEngineTest, CancelFilledOrderTest) {
+    Order sellOrder = createOrder(Side::Sell, OrderType::Limit, 101.0, 50);
+    orderBook->addOrder(sellOrder);
+    
+    Order partialBuy = createOrder(Side::Buy, OrderType::Limit, 101.0, 20);
+    orderBook->addOrder(partialBuy);
+    
+    auto resting = orderBook->findOrder(sellOrder.id);
+    ASSERT_TRUE(resting.has_value());
+    EXPECT_EQ(resting->remaining_quantity, 30);
+    
+    Order fillingBuy = createOrder(Side::Buy, OrderType::Limit, 101.0, 30);
+    orderBook->addOrder(fillingBuy);
+    
+    EXPECT_FALSE(orderBook->findOrder(sellOrder.id).has_value());
+    EXPECT_FALSE(orderBook->cancelOrder(sellOrder.id));
+    EXPECT_FALSE(orderBook->cancelOrder(12345678));
+}
+
+TEST_F(MatchingEngineTest, AmendOrderTest) {
+    Order buy1 = createOrder(Side::Buy, OrderType::Limit, 100.0, 10);
+    Order buy2 = createOrder(Side::Buy, OrderType::Limit, 100.0, 20);
+    orderBook->addOrder(buy1);
+    orderBook->addOrder(buy2);
+    
+    // Quantity down keeps buy1 at the front of the queue
+    auto trades = orderBook->amendOrder(buy1.id, buy1.price, 6);
+    ASSERT_TRUE(trades.has_value());
+    EXPECT_TRUE(trades->empty());
+    EXPECT_EQ(orderBook->findOrder(buy1.id)->remaining_quantity, 6);
+    EXPECT_EQ(orderBook->getTopOfBook().bid_quantity, 26);
+    
+    std::vector<Trade> fills = orderBook->addOrder(createOrder(Side::Sell, OrderType::Limit, 100.0, 6));
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(fills[0].buy_order_id, buy1.id);
+    
+    // Quantity up loses priority
+    Order buy3 = createOrder(Side::Buy, OrderType::Limit, 100.0, 5);
+    orderBook->addOrder(buy3);
+    orderBook->amendOrder(buy2.id, buy2.price, 25);
+    fills = orderBook->addOrder(createOrder(Side::Sell, OrderType::Limit, 100.0, 5));
+    ASSERT_EQ(fills.size(), 1);
+    EXPECT_EQ(fills[0].buy_order_id, buy3.id);
+    
+    // A price change that crosses matches immediately under the same id
+    Order sell = createOrder(Side::Sell, OrderType::Limit, 102.0, 10);
+    orderBook->addOrder(sell);
+    trades = orderBook->amendOrder(sell.id, Price::from_double(100.0), 10);
+    ASSERT_TRUE(trades.has_value());
+    ASSERT_EQ(trades->size(), 1);
+    EXPECT_EQ((*trades)[0].sell_order_id, sell.id);
+    EXPECT_EQ((*trades)[0].buy_order_id, buy2.id);
+    EXPECT_EQ(orderBook->findOrder(buy2.id)->remaining_quantity, 15);
+    EXPECT_FALSE(orderBook->findOrder(sell.id).has_value());
+    EXPECT_EQ(orderBook->getTotalOrders(), 1);
+    
+    // Unknown ids and invalid amends
+    EXPECT_FALSE(orderBook->amendOrder(sell.id, Price::from_double(100.0), 10).has_value());
+    EXPECT_THROW(orderBook->amendOrder(buy2.id, Price(), 20), std::invalid_argument);
+    EXPECT_THROW(orderBook->amendOrder(buy2.id, buy2.price, 10), std::invalid_argument);
+}
+
+TEST_F(MatchingEngineTest, CachedAggregatesTest) {
+    Order buy1 = createOrder(Side::Buy, OrderType::Limit, 100.0, 10);
+    Order buy2 = createOrder(Side::Buy, OrderType::Limit, 100.0, 20);
+    Order buy3 = createOrder(Side::Buy, OrderType::Limit, 99.0, 30);
+    Order sell1 = createOrder(Side::Sell, OrderType::Limit, 102.0, 40);
+    orderBook->addOrder(buy1);
+    orderBook->addOrder(buy2);
+    orderBook->addOrder(buy3);
+    orderBook->addOrder(sell1);
+    EXPECT_EQ(orderBook->getTotalOrders(), 4);
+    
+    // Partial fill of the second buy, the first is removed
+    Order sell2 = createOrder(Side::Sell, OrderType::Limit, 100.0, 15);
+    orderBook->addOrder(sell2);
+    EXPECT_EQ(orderBook->getTotalOrders(), 3);
+    
+    EXPECT_TRUE(orderBook->cancelOrder(buy3.id));
+    EXPECT_EQ(orderBook->getTotalOrders(), 2);
+    
+    // Only the partially filled buy and the untouched sell are left
+    int restingQuantity = 0;
+    for (uint64_t id : {buy1.id, buy2.id, buy3.id, sell1.id, sell2.id}) {
+        if (auto order = orderBook->findOrder(id)) {
+            restingQuantity += order->remaining_quantity;
+        }
+    }
+    EXPECT_EQ(restingQuantity, 15 + 40);
+    
+    Order sweep = createOrder(Side::Sell, OrderType::Market, 0.0, 15);
+    orderBook->addOrder(sweep);
+    EXPECT_EQ(orderBook->getTotalOrders(), 1);
+    
+    orderBook->clear();
+    EXPECT_EQ(orderBook->getTotalOrders(), 0);
+}
+
+TEST_F(MatchingEngineTest, TopOfBookTest) {
+    TopOfBook empty = orderBook->getTopOfBook();
+    EXPECT_TRUE(empty.bid_price.is_zero());
+    EXPECT_TRUE(empty.spread().is_zero());
+    
+    orderBook->addOrder(createOrder(Side::Buy, OrderType::Limit, 100.0, 10));
+    orderBook->addOrder(createOrder(Side::Buy, OrderType::Limit, 100.0, 15));
+    orderBook->addOrder(createOrder(Side::Sell, OrderType::Limit, 101.0, 40));
+    
+    TopOfBook top = orderBook->getTopOfBook();
+    EXPECT_EQ(top.bid_price, Price::from_double(100.0));
+    EXPECT_EQ(top.bid_quantity, 25);
+    EXPECT_EQ(top.ask_price, Price::from_double(101.0));
+    EXPECT_EQ(top.ask_quantity, 40);
+    EXPECT_EQ(top.spread(), Price::from_double(1.0));
+    EXPECT_GT(top.sequence, empty.sequence);
+    
+    Order sell = createOrder(Side::Sell, OrderType::Limit, 100.0, 12);
+    orderBook->addOrder(sell);
+    top = orderBook->getTopOfBook();
+    EXPECT_EQ(top.bid_quantity, 13);
+    EXPECT_EQ(top.last_trade_price, Price::from_double(100.0));
+    EXPECT_EQ(top.last_trade_quantity, 2);
+    EXPECT_EQ(orderBook->getBestBid(), top.bid_price);
+    EXPECT_EQ(orderBook->getSpread(), top.spread());
+}
+
+TEST_F(MatchingEngineTest, BatchMatchesSequentialTest) {
+    std::vector<Order> orders;
+    for (int i = 0; i < 200; ++i) {
+        Side side = (i % 3 == 0) ? Side::Sell : Side::Buy;
+        double price = (side == Side::Buy) ? 99.0 + (i % 5) : 100.0 + (i % 4);
+        orders.push_back(createOrder(side, OrderType::Limit, price, 5 + (i % 17)));
+    }
+    
+    OrderBook sequential;
+    std::vector<std::vector<Trade>> expected;
+    for (const auto& order : orders) {
+        expected.push_back(sequential.addOrder(order));
+    }
+    
+    std::vector<std::vector<Trade>> batched = orderBook->addOrders(orders);
+    ASSERT_EQ(batched.size(), expected.size());
+    for (size_t i = 0; i < orders.size(); ++i) {
+        ASSERT_EQ(batched[i].size(), expected[i].size());
+        for (size_t t = 0; t < batched[i].size(); ++t) {
+            EXPECT_EQ(batched[i][t].buy_order_id, expected[i][t].buy_order_id);
+            EXPECT_EQ(batched[i][t].sell_order_id, expected[i][t].sell_order_id);
+            EXPECT_EQ(batched[i][t].quantity, expected[i][t].quantity);
+        }
+    }
+    EXPECT_EQ(orderBook->getTotalOrders(), sequential.getTotalOrders());
+    EXPECT_EQ(orderBook->getTopOfBook().bid_quantity, sequential.getTopOfBook().bid_quantity);
+}
+
+TEST_F(MatchingEngineTest, ZeroAllocationMatchingTest) {
+    // Deep resting levels on both sides, so fills below never empty a level
+    for (int i = 0; i < 600; ++i) {
+        orderBook->addOrder(createOrder(Side::Buy, OrderType::Limit, 100.0, 10));
+        orderBook->addOrder(createOrder(Side::Sell, OrderType::Limit, 101.0, 10));
+    }
+    
+    std::vector<Trade> executions;
+    executions.reserve(16);
+    std::vector<Order> incoming;
+    for (int i = 0; i < 300; ++i) {
+        incoming.push_back(createOrder(Side::Sell, OrderType::Limit, 100.0, 15));   // one full, one partial fill
+        incoming.push_back(createOrder(Side::Buy, OrderType::Market, 0.0, 10));
+        incoming.push_back(createOrder(Side::Buy, OrderType::Limit, 100.0, 5));     // rests on an existing level
+        incoming.push_back(createOrder(Side::Sell, OrderType::Limit, 101.0, 10));
+    }
+    
+    size_t totalTrades = 0;
+    allocationCount = 0;
+    countAllocations = true;
+    for (const Order& order : incoming) {
+        executions.clear();
+        totalTrades += orderBook->addOrder(order, executions);
+    }
+    countAllocations = false;
+    
+    EXPECT_EQ(allocationCount.load(), 0);
+    EXPECT_EQ(totalTrades, 900);
+}
+
 TEST_F(MatchingEngineTest, PerformanceTest) {
     auto start = std::chrono::high_resolution_clock::now();
     
@@ -261,7 +715,1355 @@ TEST_F(MatchingEngineTest, PerformanceTest) {
     EXPECT_LT(duration.count(), 100000);
 }
 
+// Quantity each resting buy received from one incoming sell, in trade order
+template<typename BookType>
+std::vector<std::pair<uint64_t, int>> allocateAgainst(BookType& book, const std::vector<int>& restingSizes, int incoming) {
+    for (int size : restingSizes) {
+        book.addOrder(Order(1, intern_symbol("TEST"), Side::Buy, OrderType::Limit, Price(10000), size));
+    }
+    std::vector<std::pair<uint64_t, int>> fills;
+    for (const Trade& trade : book.addOrder(Order(2, intern_symbol("TEST"), Side::Sell, OrderType::Limit, Price(10000), incoming))) {
+        fills.emplace_back(trade.buy_order_id, trade.quantity);
+    }
+    return fills;
+}
+
+TEST(MatchingPolicyTest, ProRataAllocationTest) {
+    ProRataOrderBook book;
+    auto fills = allocateAgainst(book, {10, 30, 60}, 50);
+    ASSERT_EQ(fills.size(), 3);
+    EXPECT_EQ(fills[0].second, 5);
+    EXPECT_EQ(fills[1].second, 15);
+    EXPECT_EQ(fills[2].second, 30);
+    EXPECT_EQ(book.getTopOfBook().bid_quantity, 50);
+    
+    // Rounding leftovers go to the oldest order
+    ProRataOrderBook evenBook;
+    fills = allocateAgainst(evenBook, {10, 10, 10}, 10);
+    ASSERT_EQ(fills.size(), 4);
+    EXPECT_EQ(fills[3].first, fills[0].first);
+    EXPECT_EQ(fills[0].second + fills[3].second, 4);
+    EXPECT_EQ(evenBook.getTotalOrders(), 3);
+    
+    // Enough quantity to clear the level fills everyone completely
+    ProRataOrderBook sweepBook;
+    fills = allocateAgainst(sweepBook, {10, 20}, 40);
+    ASSERT_EQ(fills.size(), 2);
+    EXPECT_TRUE(sweepBook.getTopOfBook().bid_price.is_zero());
+    EXPECT_EQ(sweepBook.getTopOfBook().ask_quantity, 10);
+}
+
+TEST(MatchingPolicyTest, TopOrderProRataAllocationTest) {
+    TopOrderProRataOrderBook book;
+    auto fills = allocateAgainst(book, {10, 30, 60}, 40);
+    ASSERT_EQ(fills.size(), 3);
+    EXPECT_EQ(fills[0].second, 10);
+    EXPECT_EQ(fills[1].second, 10);
+    EXPECT_EQ(fills[2].second, 20);
+    EXPECT_EQ(book.getTotalOrders(), 2);
+    
+    // FIFO for comparison: the same flow only reaches the first two orders
+    OrderBook fifoBook;
+    fills = allocateAgainst(fifoBook, {10, 30, 60}, 40);
+    ASSERT_EQ(fills.size(), 2);
+    EXPECT_EQ(fills[1].second, 30);
+}
+
+TEST(ExchangeTest, SymbolIsolationTest) {
+    Exchange exchange;
+    
+    Order buyAAA(1, intern_symbol("AAA"), Side::Buy, OrderType::Limit, Price::from_double(100.0), 10);
+    Order sellBBB(2, intern_symbol("BBB"), Side::Sell, OrderType::Limit, Price::from_double(100.0), 10);
+    
+    // Crossing prices on different symbols must not trade
+    EXPECT_TRUE(exchange.addOrder(buyAAA).empty());
+    EXPECT_TRUE(exchange.addOrder(sellBBB).empty());
+    EXPECT_EQ(exchange.getTotalOrders(), 2);
+    
+    ASSERT_NE(exchange.findBook(intern_symbol("AAA")), nullptr);
+    ASSERT_NE(exchange.findBook(intern_symbol("BBB")), nullptr);
+    EXPECT_EQ(exchange.findBook(intern_symbol("CCC")), nullptr);
+    EXPECT_EQ(exchange.getSymbols().size(), 2);
+    
+    Order sellAAA(3, intern_symbol("AAA"), Side::Sell, OrderType::Limit, Price::from_double(100.0), 10);
+    std::vector<Trade> trades = exchange.addOrder(sellAAA);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(symbol_name(trades[0].symbol), "AAA");
+    EXPECT_EQ(trades[0].buy_order_id, buyAAA.id);
+    
+    EXPECT_EQ(exchange.findBook(intern_symbol("AAA"))->getTradeCount(), 1);
+    EXPECT_EQ(exchange.findBook(intern_symbol("BBB"))->getTradeCount(), 0);
+    EXPECT_EQ(exchange.getTradeLog().size(), 1);
+}
+
+TEST(ExchangeTest, CancelRoutingTest) {
+    Exchange exchange;
+    
+    Order buyAAA(1, intern_symbol("AAA"), Side::Buy, OrderType::Limit, Price::from_double(50.0), 10);
+    Order buyBBB(2, intern_symbol("BBB"), Side::Buy, OrderType::Limit, Price::from_double(50.0), 10);
+    exchange.addOrder(buyAAA);
+    exchange.addOrder(buyBBB);
+    
+    EXPECT_FALSE(exchange.cancelOrder(intern_symbol("AAA"), buyBBB.id));
+    EXPECT_TRUE(exchange.cancelOrder(intern_symbol("BBB"), buyBBB.id));
+    EXPECT_FALSE(exchange.cancelOrder(intern_symbol("CCC"), buyAAA.id));
+    EXPECT_TRUE(exchange.cancelOrder(buyAAA.id));
+    EXPECT_FALSE(exchange.cancelOrder(buyAAA.id));
+    EXPECT_EQ(exchange.getTotalOrders(), 0);
+}
+
+TEST(OrderPoolTest, NodeReuseTest) {
+    OrderPool pool(4);
+    Order order;
+    order.symbol = intern_symbol("TEST");
+    
+    std::vector<OrderNode*> nodes;
+    for (int i = 0; i < 4; ++i) {
+        order.id = i + 1;
+        nodes.push_back(pool.acquire(order));
+    }
+    EXPECT_EQ(pool.capacity(), 4);
+    EXPECT_EQ(pool.inUse(), 4);
+    EXPECT_EQ(nodes[2]->id, 3);
+    EXPECT_EQ(symbol_name(pool.details(nodes[2]).symbol), "TEST");
+    
+    // Released nodes are handed out again before the pool grows
+    pool.release(nodes[1]);
+    order.id = 99;
+    EXPECT_EQ(pool.acquire(order), nodes[1]);
+    EXPECT_EQ(nodes[1]->id, 99);
+    EXPECT_EQ(pool.details(nodes[1]).id, 99);
+    EXPECT_EQ(pool.capacity(), 4);
+    
+    pool.acquire(order);
+    EXPECT_EQ(pool.capacity(), 8);
+    EXPECT_EQ(pool.inUse(), 5);
+    
+    pool.releaseAll();
+    EXPECT_EQ(pool.inUse(), 0);
+}
+
+TEST(OrderPoolTest, PriceLevelLinkingTest) {
+    OrderPool pool;
+    Order order;
+    PriceLevel level;
+    
+    std::vector<OrderNode*> nodes;
+    for (int i = 0; i < 3; ++i) {
+        order.id = i + 1;
+        order.remaining_quantity = 10 * (i + 1);
+        nodes.push_back(pool.acquire(order));
+        level.push_back(nodes.back());
+    }
+    EXPECT_EQ(level.quantity(), 60);
+    
+    // Unlink from the middle, then the head
+    level.erase(nodes[1]);
+    EXPECT_EQ(level.size(), 2);
+    EXPECT_EQ(level.quantity(), 40);
+    EXPECT_EQ(level.front(), nodes[0]);
+    EXPECT_EQ(nodes[0]->next, nodes[2]);
+    EXPECT_EQ(nodes[2]->prev, nodes[0]);
+    
+    level.erase(nodes[0]);
+    EXPECT_EQ(level.front(), nodes[2]);
+    EXPECT_EQ(level.begin()->id, 3);
+    
+    level.erase(nodes[2]);
+    EXPECT_TRUE(level.empty());
+    EXPECT_EQ(level.begin(), level.end());
+}
+
+TEST(OrderPoolTest, OrderIndexTest) {
+    OrderIndex index(16);
+    std::vector<OrderNode> nodes(1000);
+    
+    // Enough entries to force several rehashes and long probe runs
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        index.insert(id, &nodes[id - 1]);
+    }
+    EXPECT_EQ(index.size(), 1000);
+    
+    for (uint64_t id = 1; id <= 1000; id += 2) {
+        EXPECT_TRUE(index.erase(id));
+    }
+    EXPECT_FALSE(index.erase(1));
+    EXPECT_EQ(index.size(), 500);
+    
+    for (uint64_t id = 1; id <= 1000; ++id) {
+        if (id % 2 == 1) {
+            EXPECT_EQ(index.find(id), nullptr);
+        } else {
+            EXPECT_EQ(index.find(id), &nodes[id - 1]);
+        }
+    }
+    
+    index.clear();
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_EQ(index.find(2), nullptr);
+}
+
+TEST(PriceLadderTest, BestLevelTrackingTest) {
+    LadderPriceLevels<std::greater<Price>> bids(64);
+    LadderPriceLevels<std::less<Price>> asks(64);
+    
+    bids[Price(100)];
+    bids[Price(103)];
+    bids[Price(101)];
+    asks[Price(110)];
+    asks[Price(108)];
+    
+    EXPECT_EQ(bids.size(), 3);
+    EXPECT_EQ(bids.bestPrice(), Price(103));
+    EXPECT_EQ(asks.bestPrice(), Price(108));
+    
+    // Removing the best level falls back to the next occupied one
+    bids.erase(Price(103));
+    EXPECT_EQ(bids.bestPrice(), Price(101));
+    asks.erase(Price(108));
+    EXPECT_EQ(asks.bestPrice(), Price(110));
+    
+    EXPECT_EQ(bids.find(Price(103)), nullptr);
+    EXPECT_NE(bids.find(Price(100)), nullptr);
+    
+    std::vector<Price> visited;
+    bids.forEach([&](Price price, const PriceLevel&) {
+        visited.push_back(price);
+        return true;
+    });
+    ASSERT_EQ(visited.size(), 2);
+    EXPECT_EQ(visited[0], Price(101));
+    EXPECT_EQ(visited[1], Price(100));
+}
+
+TEST(PriceLadderTest, RecenterTest) {
+    LadderPriceLevels<std::less<Price>> asks(64);
+    
+    OrderNode node;
+    node.id = 1;
+    asks[Price(1000)].push_back(&node);
+    
+    // Far outside the initial window, and wider than its capacity
+    asks[Price(1000000)];
+    asks[Price(-500)];
+    
+    EXPECT_GE(asks.capacity(), 64);
+    EXPECT_EQ(asks.size(), 3);
+    EXPECT_EQ(asks.bestPrice(), Price(-500));
+    
+    // Existing orders survive the move still linked into their level
+    ASSERT_NE(asks.find(Price(1000)), nullptr);
+    EXPECT_EQ(asks.find(Price(1000))->front(), &node);
+    EXPECT_EQ(asks.find(Price(1000))->begin()->id, 1);
+    asks.find(Price(1000))->clear();
+    
+    asks.erase(Price(-500));
+    EXPECT_EQ(asks.bestPrice(), Price(1000));
+    asks.erase(Price(1000));
+    EXPECT_EQ(asks.bestPrice(), Price(1000000));
+}
+
+TEST(PriceLadderTest, OverflowTest) {
+    LadderPriceLevels<std::greater<Price>> bids(64);
+    
+    bids[Price(100)];
+    bids[Price(101)];
+    
+    // Too far from the window's levels to share it, so kept aside
+    bids[Price(50000000)];
+    bids[Price(-50000000)];
+    EXPECT_LE(bids.capacity(), LadderPriceLevels<std::greater<Price>>::MAX_CAPACITY);
+    EXPECT_EQ(bids.overflowSize(), 2);
+    EXPECT_EQ(bids.size(), 4);
+    EXPECT_EQ(bids.bestPrice(), Price(50000000));
+    EXPECT_NE(bids.find(Price(-50000000)), nullptr);
+    
+    std::vector<Price> visited;
+    bids.forEach([&](Price price, const PriceLevel&) {
+        visited.push_back(price);
+        return true;
+    });
+    EXPECT_EQ(visited, (std::vector<Price>{Price(50000000), Price(101), Price(100), Price(-50000000)}));
+    
+    bids.erase(Price(50000000));
+    EXPECT_EQ(bids.bestPrice(), Price(101));
+    bids.erase(Price(101));
+    bids.erase(Price(100));
+    EXPECT_EQ(bids.bestPrice(), Price(-50000000));
+    
+    // Once the window is free to move, overflow levels it covers move into it
+    bids[Price(-50000010)];
+    EXPECT_EQ(bids.overflowSize(), 0);
+    EXPECT_EQ(bids.size(), 2);
+    EXPECT_EQ(bids.bestPrice(), Price(-50000000));
+    
+    // Far-away orders rest and trade in a book just as with map levels
+    MapOrderBook mapBook;
+    LadderOrderBook ladderBook;
+    uint64_t nextId = 1;
+    for (int64_t ticks : {10000, 900000000, 10010, 1, 9990}) {
+        for (Side side : {Side::Buy, Side::Sell}) {
+            Order order(1, intern_symbol("TEST"), side, OrderType::Limit, Price(ticks + (side == Side::Sell ? 5 : 0)), 10);
+            order.id = nextId++;
+            EXPECT_EQ(mapBook.addOrder(order).size(), ladderBook.addOrder(order).size());
+            ASSERT_EQ(mapBook.getBestBid(), ladderBook.getBestBid());
+            ASSERT_EQ(mapBook.getBestAsk(), ladderBook.getBestAsk());
+        }
+    }
+    EXPECT_EQ(mapBook.getTotalOrders(), ladderBook.getTotalOrders());
+    EXPECT_EQ(mapBook.getTradeCount(), ladderBook.getTradeCount());
+}
+
+TEST(PriceLadderTest, MatchesMapBackendTest) {
+    MapOrderBook mapBook;
+    LadderOrderBook ladderBook;
+    
+    std::mt19937 rng(42);
+    std::vector<uint64_t> liveIds;
+    uint64_t nextId = 1;
+    
+    for (int i = 0; i < 20000; ++i) {
+        int action = rng() % 10;
+        
+        if (action == 0 && !liveIds.empty()) {
+            uint64_t id = liveIds[rng() % liveIds.size()];
+            EXPECT_EQ(mapBook.cancelOrder(id), ladderBook.cancelOrder(id));
+            continue;
+        }
+        
+        Order order;
+        order.id = nextId++;
+        order.symbol = intern_symbol("TEST");
+        order.side = (rng() % 2 == 0) ? Side::Buy : Side::Sell;
+        order.type = (action == 1) ? OrderType::Market : OrderType::Limit;
+        // Mostly near the touch, occasionally far enough to force a recenter
+        int64_t offset = (rng() % 50 == 0) ? static_cast<int64_t>(rng() % 20000) : static_cast<int64_t>(rng() % 40);
+        order.price = Price(10000 + (order.is_buy() ? -offset : offset) + 20 - static_cast<int64_t>(rng() % 40));
+        order.quantity = 1 + rng() % 100;
+        order.remaining_quantity = order.quantity;
+        order.status = OrderStatus::Active;
+        
+        std::vector<Trade> mapTrades = mapBook.addOrder(order);
+        std::vector<Trade> ladderTrades = ladderBook.addOrder(order);
+        
+        ASSERT_EQ(mapTrades.size(), ladderTrades.size());
+        for (size_t t = 0; t < mapTrades.size(); ++t) {
+            EXPECT_EQ(mapTrades[t].buy_order_id, ladderTrades[t].buy_order_id);
+            EXPECT_EQ(mapTrades[t].sell_order_id, ladderTrades[t].sell_order_id);
+            EXPECT_EQ(mapTrades[t].price, ladderTrades[t].price);
+            EXPECT_EQ(mapTrades[t].quantity, ladderTrades[t].quantity);
+        }
+        
+        if (order.is_limit()) {
+            liveIds.push_back(order.id);
+        }
+        
+        ASSERT_EQ(mapBook.getBestBid(), ladderBook.getBestBid());
+        ASSERT_EQ(mapBook.getBestAsk(), ladderBook.getBestAsk());
+    }
+    
+    EXPECT_GT(mapBook.getTradeCount(), 0);
+    EXPECT_EQ(mapBook.getTotalOrders(), ladderBook.getTotalOrders());
+    EXPECT_EQ(mapBook.getTradeCount(), ladderBook.getTradeCount());
+}
+
+TEST(SequencerTest, MpscQueueOrderingTest) {
+    MpscQueue<std::pair<int, int>> queue(64);
+    const int producers = 4;
+    const int perProducer = 5000;
+    
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p]() {
+            for (int i = 0; i < perProducer; ++i) {
+                while (!queue.tryPush({p, i})) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    // Each producer's values must come out in the order it pushed them
+    std::vector<int> nextExpected(producers, 0);
+    int received = 0;
+    std::pair<int, int> item;
+    while (received < producers * perProducer) {
+        if (queue.tryPop(item)) {
+            ASSERT_EQ(item.second, nextExpected[item.first]);
+            ++nextExpected[item.first];
+            ++received;
+        }
+    }
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(queue.tryPop(item));
+}
+
+TEST(SequencerTest, ConcurrentSubmitTest) {
+    Exchange exchange;
+    Sequencer sequencer(exchange, 128);
+    sequencer.start();
+    
+    const int threadsCount = 4;
+    const int perThread = 500;
+    std::atomic<int> totalFilled{0};
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadsCount; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                uint64_t clientId = static_cast<uint64_t>(t * perThread + i + 1);
+                Side side = (i % 2 == 0) ? Side::Buy : Side::Sell;
+                Order order(clientId, intern_symbol("SIM"), side, OrderType::Limit, Price::from_double(100.0), 10);
+                for (const auto& trade : sequencer.submitOrder(order).get()) {
+                    totalFilled.fetch_add(trade.quantity);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    // Everything crosses at one price, so only the imbalance can rest
+    const OrderBook& book = exchange.getOrCreateBook(intern_symbol("SIM"));
+    EXPECT_EQ(totalFilled.load() * 2 + static_cast<int>(book.getTotalOrders()) * 10,
+              threadsCount * perThread * 10);
+    
+    Order resting(99999, intern_symbol("SIM"), Side::Buy, OrderType::Limit, Price::from_double(90.0), 5);
+    EXPECT_TRUE(sequencer.submitOrder(resting).get().empty());
+    EXPECT_TRUE(sequencer.submitCancel(resting.id, intern_symbol("SIM")).get());
+    EXPECT_FALSE(sequencer.submitCancel(resting.id).get());
+    
+    sequencer.stop();
+    EXPECT_FALSE(sequencer.isRunning());
+    EXPECT_EQ(sequencer.getProcessedCount(), static_cast<uint64_t>(threadsCount * perThread + 3));
+}
+
+TEST(SequencerTest, SubmitAfterStopTest) {
+    Exchange exchange;
+    Sequencer sequencer(exchange, 16);
+    
+    // Nothing would ever execute these, so their futures fail instead of hanging
+    Order early(1, intern_symbol("SIM"), Side::Buy, OrderType::Limit, Price::from_double(90.0), 5);
+    EXPECT_THROW(sequencer.submitOrder(early).get(), std::runtime_error);
+    
+    sequencer.start();
+    
+    // Submitters racing stop() either run or are rejected, never left waiting
+    std::atomic<int> executed{0};
+    std::atomic<int> rejected{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                auto result = sequencer.submitCancel(static_cast<uint64_t>(t * 10000 + i), intern_symbol("SIM"));
+                if (result.wait_for(std::chrono::seconds(10)) != std::future_status::ready) {
+                    ADD_FAILURE() << "Submit left waiting after stop";
+                    return;
+                }
+                try {
+                    result.get();
+                    executed++;
+                } catch (const std::runtime_error&) {
+                    rejected++;
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    sequencer.stop();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    EXPECT_EQ(executed.load() + rejected.load(), 8000);
+    EXPECT_EQ(sequencer.getProcessedCount(), static_cast<uint64_t>(executed.load()));
+    
+    Order late(2, intern_symbol("SIM"), Side::Buy, OrderType::Limit, Price::from_double(90.0), 5);
+    EXPECT_THROW(sequencer.submitOrder(late).get(), std::runtime_error);
+}
+
+TEST(SeqLockTest, ConsistentReadTest) {
+    struct Pair {
+        int64_t first = 0;
+        int64_t second = 0;
+        int64_t third = 0;
+    };
+    SeqLock<Pair> lock;
+    std::atomic<bool> done{false};
+    
+    std::thread writer([&]() {
+        for (int64_t i = 1; i <= 200000; ++i) {
+            lock.store(Pair{i, -i, i * 2});
+        }
+        done = true;
+    });
+    
+    // Readers must never observe a half-written value
+    int64_t lastSeen = 0;
+    while (!done) {
+        Pair value = lock.load();
+        ASSERT_EQ(value.second, -value.first);
+        ASSERT_EQ(value.third, value.first * 2);
+        ASSERT_GE(value.first, lastSeen);
+        lastSeen = value.first;
+    }
+    writer.join();
+    EXPECT_EQ(lock.load().first, 200000);
+}
+
+TEST(TradeLogTest, RingEvictionTest) {
+    TradeLog log(3);
+    for (int i = 1; i <= 5; ++i) {
+        Trade trade(i, i + 100, intern_symbol("TEST"), Price(1000 + i), i);
+        trade.trade_id = i;
+        log.append(trade);
+    }
+    
+    // Only the three most recent trades stay in memory, oldest first
+    EXPECT_EQ(log.size(), 3);
+    EXPECT_EQ(log.totalCount(), 5);
+    EXPECT_EQ(log.evictedCount(), 2);
+    
+    std::vector<uint64_t> ids;
+    for (const Trade& trade : log) {
+        ids.push_back(trade.trade_id);
+    }
+    EXPECT_EQ(ids, (std::vector<uint64_t>{3, 4, 5}));
+    EXPECT_EQ(log.back().trade_id, 5);
+    
+    log.clear();
+    EXPECT_TRUE(log.empty());
+    EXPECT_EQ(log.begin(), log.end());
+}
+
+TEST(TradeLogTest, SpillRoundTripTest) {
+    std::string path = ::testing::TempDir() + "velocore_trade_spill_test.trades";
+    std::remove(path.c_str());
+    int64_t startMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    {
+        OrderBook book(DEFAULT_TICK_SIZE, 2, path);
+        for (int i = 0; i < 5; ++i) {
+            Order sell(1, intern_symbol("SPILL"), Side::Sell, OrderType::Limit, Price(10000 + i), 10 + i);
+            Order buy(2, intern_symbol("SPILL"), Side::Buy, OrderType::Limit, Price(10000 + i), 10 + i);
+            book.addOrder(sell);
+            book.addOrder(buy);
+        }
+        EXPECT_EQ(book.getTradeCount(), 5);
+        EXPECT_EQ(book.getTradeLog().size(), 2);
+        
+        int visited = 0;
+        book.forEachTrade([&visited](const Trade&) {
+            return ++visited < 1;
+        });
+        EXPECT_EQ(visited, 1);
+    }
+    
+    // The three evicted trades were written to disk in execution order
+    std::vector<Trade> spilled = TradeLog::readSpillFile(path);
+    ASSERT_EQ(spilled.size(), 3);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_EQ(symbol_name(spilled[i].symbol), "SPILL");
+        EXPECT_EQ(spilled[i].price, Price(10000 + i));
+        EXPECT_EQ(spilled[i].quantity, 10 + i);
+    }
+    EXPECT_LT(spilled[0].trade_id, spilled[2].trade_id);
+    
+    // Records hold wall-clock time, so it reads back as when the trades happened
+    int64_t endMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (const auto& trade : spilled) {
+        EXPECT_GE(Clock::toUnixMillis(trade.timestamp), startMillis - 1);
+        EXPECT_LE(Clock::toUnixMillis(trade.timestamp), endMillis + 1);
+    }
+    std::ifstream raw(path, std::ios::binary);
+    TradeLog::SpillRecord record{};
+    ASSERT_TRUE(raw.read(reinterpret_cast<char*>(&record), sizeof(record)));
+    EXPECT_GE(record.timestamp_ns / 1000000, startMillis - 1);
+    EXPECT_LE(record.timestamp_ns / 1000000, endMillis + 1);
+    raw.close();
+    std::remove(path.c_str());
+}
+
+TEST(TradeLogTest, TradeLookupTest) {
+    TradeLog log(4);
+    
+    // Dense ids use the direct offset, sparse ids fall back to a search
+    for (uint64_t id : {10, 11, 12, 13}) {
+        Trade trade(1, 2, intern_symbol("TEST"), Price(100), 1);
+        trade.trade_id = id;
+        log.append(trade);
+    }
+    ASSERT_NE(log.find(12), nullptr);
+    EXPECT_EQ(log.find(12)->trade_id, 12);
+    EXPECT_EQ(log.find(9), nullptr);
+    EXPECT_EQ(log.lowerBound(14), 4);
+    
+    for (uint64_t id : {20, 25}) {
+        Trade trade(1, 2, intern_symbol("TEST"), Price(100), 1);
+        trade.trade_id = id;
+        log.append(trade);
+    }
+    EXPECT_EQ(log.find(11), nullptr);
+    ASSERT_NE(log.find(25), nullptr);
+    EXPECT_EQ(log.find(21), nullptr);
+    EXPECT_EQ(log.lowerBound(21), 3);
+}
+
+TEST(ExchangeTest, BatchRoutingTest) {
+    Exchange exchange;
+    std::vector<Order> orders = {
+        Order(1, intern_symbol("AAA"), Side::Sell, OrderType::Limit, Price(100), 10),
+        Order(2, intern_symbol("BBB"), Side::Sell, OrderType::Limit, Price(100), 10),
+        Order(3, intern_symbol("AAA"), Side::Buy, OrderType::Limit, Price(100), 4),
+        Order(4, intern_symbol("BBB"), Side::Buy, OrderType::Limit, Price(99), 10),
+        Order(5, intern_symbol("AAA"), Side::Buy, OrderType::Market, Price(), 6)
+    };
+    
+    std::vector<std::vector<Trade>> results = exchange.addOrders(orders);
+    ASSERT_EQ(results.size(), orders.size());
+    EXPECT_TRUE(results[0].empty());
+    EXPECT_TRUE(results[1].empty());
+    ASSERT_EQ(results[2].size(), 1);
+    EXPECT_EQ(results[2][0].sell_order_id, orders[0].id);
+    EXPECT_TRUE(results[3].empty());
+    ASSERT_EQ(results[4].size(), 1);
+    EXPECT_EQ(results[4][0].quantity, 6);
+    
+    EXPECT_TRUE(exchange.findBook(intern_symbol("AAA"))->isEmpty());
+    EXPECT_EQ(exchange.findBook(intern_symbol("BBB"))->getTotalOrders(), 2);
+}
+
+TEST(ExchangeTest, TradePaginationTest) {
+    Exchange exchange;
+    std::vector<uint64_t> tradeIds;
+    for (int i = 0; i < 10; ++i) {
+        SymbolId symbol = intern_symbol((i % 2 == 0) ? "AAA" : "BBB");
+        exchange.addOrder(Order(1, symbol, Side::Sell, OrderType::Limit, Price(100), 5));
+        for (const Trade& trade : exchange.addOrder(Order(2, symbol, Side::Buy, OrderType::Limit, Price(100), 5))) {
+            tradeIds.push_back(trade.trade_id);
+        }
+    }
+    ASSERT_EQ(tradeIds.size(), 10);
+    
+    // Walk every trade with a small page size, following the cursor
+    std::vector<uint64_t> paged;
+    uint64_t cursor = 0;
+    while (true) {
+        std::vector<Trade> page = exchange.getTradesSince(cursor, 3);
+        if (page.empty()) break;
+        EXPECT_LE(page.size(), 3);
+        for (const Trade& trade : page) {
+            paged.push_back(trade.trade_id);
+        }
+        cursor = page.back().trade_id;
+    }
+    EXPECT_EQ(paged, tradeIds);
+    
+    auto found = exchange.findTrade(tradeIds[3]);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(symbol_name(found->symbol), "BBB");
+    EXPECT_FALSE(exchange.findTrade(tradeIds.back() + 1000).has_value());
+    
+    OrderBook* book = exchange.findBook(intern_symbol("AAA"));
+    ASSERT_NE(book, nullptr);
+    EXPECT_EQ(book->getTradesSince(tradeIds[4], 10).size(), 2);
+}
+
+TEST(ExchangeTest, TradeSequenceTest) {
+    Exchange exchange;
+    SymbolId aaa = intern_symbol("SEQA");
+    SymbolId bbb = intern_symbol("SEQB");
+    
+    std::vector<Trade> trades;
+    for (int i = 0; i < 6; ++i) {
+        SymbolId symbol = (i % 3 == 0) ? bbb : aaa;
+        exchange.addOrder(Order(1, symbol, Side::Sell, OrderType::Limit, Price(100), 5));
+        for (const Trade& trade : exchange.addOrder(Order(2, symbol, Side::Buy, OrderType::Limit, Price(100), 5))) {
+            trades.push_back(trade);
+        }
+    }
+    ASSERT_EQ(trades.size(), 6);
+    
+    // Each book numbers its own trades 1, 2, 3... and stamps its symbol on the id
+    uint64_t expected[2] = {1, 1};
+    for (const Trade& trade : trades) {
+        int book = (trade.symbol == aaa) ? 0 : 1;
+        EXPECT_EQ(trade_symbol(trade.trade_id), trade.symbol);
+        EXPECT_EQ(trade_sequence(trade.trade_id), expected[book]++);
+    }
+    
+    // Sequences survive a clear, so ids are never handed out twice
+    OrderBook& book = exchange.getOrCreateBook(aaa);
+    book.clear();
+    book.addOrder(Order(1, aaa, Side::Sell, OrderType::Limit, Price(100), 5));
+    std::vector<Trade> after = book.addOrder(Order(2, aaa, Side::Buy, OrderType::Limit, Price(100), 5));
+    ASSERT_EQ(after.size(), 1);
+    EXPECT_EQ(trade_sequence(after[0].trade_id), expected[0]);
+    EXPECT_TRUE(exchange.findTrade(after[0].trade_id).has_value());
+}
+
+TEST(ExchangeTest, ConcurrentTradeCursorTest) {
+    Exchange exchange;
+    SymbolId symbols[4] = {intern_symbol("CURA"), intern_symbol("CURB"), intern_symbol("CURC"), intern_symbol("CURD")};
+    for (SymbolId symbol : symbols) {
+        exchange.getOrCreateBook(symbol);
+    }
+    
+    // Several books trade concurrently while a reader tails the merged stream
+    const int TRADES_PER_BOOK = 5000;
+    std::atomic<int> writersDone{0};
+    std::vector<std::thread> writers;
+    for (SymbolId symbol : symbols) {
+        writers.emplace_back([&, symbol]() {
+            for (int i = 0; i < TRADES_PER_BOOK; ++i) {
+                exchange.addOrder(Order(1, symbol, Side::Sell, OrderType::Limit, Price(100), 1));
+                exchange.addOrder(Order(2, symbol, Side::Buy, OrderType::Limit, Price(100), 1));
+            }
+            writersDone++;
+        });
+    }
+    
+    std::set<uint64_t> seen;
+    uint64_t cursor = 0;
+    bool finalPass = false;
+    while (true) {
+        std::vector<Trade> page = exchange.getTradesSince(cursor, 7);
+        for (const Trade& trade : page) {
+            EXPECT_TRUE(seen.insert(trade.trade_id).second);
+        }
+        if (!page.empty()) {
+            cursor = page.back().trade_id;
+        } else if (finalPass) {
+            break;
+        } else if (writersDone.load() == 4) {
+            finalPass = true;
+        }
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    
+    // Nothing was left behind the cursor
+    EXPECT_EQ(seen.size(), static_cast<size_t>(4 * TRADES_PER_BOOK));
+}
+
+TEST(ExchangeTest, TradeLookupByEngineIdTest) {
+    Exchange exchange;
+    SymbolId symbol = intern_symbol("LOOKUP");
+    exchange.addOrder(Order(1, symbol, Side::Sell, OrderType::Limit, Price(100), 5));
+    std::vector<Trade> trades = exchange.addOrder(Order(2, symbol, Side::Buy, OrderType::Limit, Price(100), 5));
+    ASSERT_EQ(trades.size(), 1);
+    
+    // Symbol bits put every id past 2^40, so routes must take ids as 64-bit
+    uint64_t tradeId = trades[0].trade_id;
+    EXPECT_GE(tradeId, uint64_t(1) << TRADE_SEQUENCE_BITS);
+    EXPECT_NE(static_cast<uint64_t>(static_cast<int>(tradeId)), tradeId);
+    
+    // As GET /trades/<id> parses it from the path, with and without ?symbol=
+    uint64_t parsed = std::stoull(std::to_string(tradeId));
+    auto found = exchange.findTrade(parsed);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->trade_id, tradeId);
+    OrderBook* book = exchange.findBook(symbol);
+    ASSERT_NE(book, nullptr);
+    EXPECT_TRUE(book->findTrade(parsed).has_value());
+}
+
+TEST(ExchangeTest, ListedSymbolTest) {
+    Exchange exchange;
+    SymbolId listed = intern_symbol("LISTED");
+    exchange.getOrCreateBook(listed);
+    
+    EXPECT_EQ(exchange.findListedSymbol("LISTED"), listed);
+    
+    // Interned elsewhere but without a book, or never seen at all
+    intern_symbol("NOBOOK");
+    EXPECT_TRUE(exchange.findListedSymbol("NOBOOK").empty());
+    EXPECT_TRUE(exchange.findListedSymbol("NEVERSEEN").empty());
+    EXPECT_TRUE(find_symbol("NEVERSEEN").empty());
+    EXPECT_TRUE(exchange.findListedSymbol("").empty());
+}
+
+TEST(RollingWindowTest, OhlcvAndExpiryTest) {
+    using namespace std::chrono;
+    RollingWindow window(seconds(1));
+    steady_clock::time_point start(hours(1));
+    SymbolId symbol = intern_symbol("TEST");
+    
+    auto tradeAt = [&](milliseconds offset, int64_t ticks, int quantity) {
+        Trade trade(1, 2, symbol, Price(ticks), quantity);
+        trade.timestamp = start + offset;
+        window.add(trade);
+    };
+    tradeAt(milliseconds(0), 10000, 10);
+    tradeAt(milliseconds(200), 10200, 30);
+    tradeAt(milliseconds(400), 9900, 20);
+    tradeAt(milliseconds(600), 10100, 40);
+    
+    WindowSummary summary = window.summary(start + milliseconds(700));
+    EXPECT_EQ(summary.trades, 4u);
+    EXPECT_EQ(summary.volume, 100);
+    EXPECT_EQ(summary.open, Price(10000));
+    EXPECT_EQ(summary.high, Price(10200));
+    EXPECT_EQ(summary.low, Price(9900));
+    EXPECT_EQ(summary.close, Price(10100));
+    EXPECT_DOUBLE_EQ(summary.vwap_ticks, (10000.0 * 10 + 10200.0 * 30 + 9900.0 * 20 + 10100.0 * 40) / 100);
+    // Only 700ms of history exists yet, so the rate isn't diluted over the full second
+    EXPECT_EQ(summary.covered, milliseconds(700));
+    EXPECT_DOUBLE_EQ(summary.trades_per_second(), 4.0 / 0.7);
+    
+    // The first two trades have left the window
+    summary = window.summary(start + milliseconds(1300));
+    EXPECT_EQ(summary.trades, 2u);
+    EXPECT_EQ(summary.covered, milliseconds(990));
+    EXPECT_EQ(summary.open, Price(9900));
+    EXPECT_EQ(summary.high, Price(10100));
+    
+    // A new trade recycles an expired bucket without disturbing the rest
+    tradeAt(milliseconds(1200), 10500, 5);
+    summary = window.summary(start + milliseconds(1300));
+    EXPECT_EQ(summary.trades, 3u);
+    EXPECT_EQ(summary.volume, 65);
+    EXPECT_EQ(summary.close, Price(10500));
+    
+    // Late trades for buckets already recycled are dropped
+    tradeAt(milliseconds(200), 1, 1000);
+    EXPECT_EQ(window.summary(start + milliseconds(1300)).volume, 65);
+    
+    EXPECT_EQ(window.summary(start + seconds(10)).trades, 0u);
+    EXPECT_THROW(RollingWindow(nanoseconds(0)), std::invalid_argument);
+}
+
+TEST(RollingWindowTest, OrderBookAnalyticsTest) {
+    OrderBook book;
+    SymbolId symbol = intern_symbol("TEST");
+    book.addOrder(Order(1, symbol, Side::Sell, OrderType::Limit, Price::from_double(100.0), 10));
+    book.addOrder(Order(1, symbol, Side::Sell, OrderType::Limit, Price::from_double(101.0), 10));
+    book.addOrder(Order(1, symbol, Side::Buy, OrderType::Market, Price(), 15));
+    
+    for (size_t window = 0; window < TradeAnalytics::WINDOW_COUNT; ++window) {
+        WindowSummary summary = book.getWindowSummary(window);
+        EXPECT_EQ(summary.trades, 2u);
+        EXPECT_EQ(summary.volume, 15);
+        EXPECT_EQ(summary.open, Price::from_double(100.0));
+        EXPECT_EQ(summary.close, Price::from_double(101.0));
+        EXPECT_NEAR(summary.vwap_ticks, (10000.0 * 10 + 10100.0 * 5) / 15, 1e-9);
+    }
+    EXPECT_EQ(book.getWindowSummary(2).length, std::chrono::minutes(5));
+    
+    book.clear();
+    EXPECT_EQ(book.getWindowSummary(1).trades, 0u);
+    EXPECT_EQ(book.getWindowSummary(1).trades_per_second(), 0.0);
+}
+
+TEST(LatencyHistogramTest, BucketPrecisionTest) {
+    // Small values are exact, larger ones within one sub-bucket
+    for (uint64_t value : {0ull, 1ull, 63ull, 64ull, 1000ull, 123456789ull, ~0ull}) {
+        size_t bucket = LatencyHistogram::bucketFor(value);
+        ASSERT_LT(bucket, LatencyHistogram::BUCKET_COUNT);
+        uint64_t upper = LatencyHistogram::bucketUpperBound(bucket);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(upper - value, value / LatencyHistogram::SUB_BUCKET_COUNT);
+        if (bucket > 0) {
+            EXPECT_LT(LatencyHistogram::bucketUpperBound(bucket - 1), value);
+        }
+    }
+    
+    LatencyHistogram histogram;
+    for (uint64_t nanos = 1; nanos <= 1000; ++nanos) {
+        histogram.record(nanos * 1000);
+    }
+    LatencySnapshot snapshot;
+    histogram.mergeInto(snapshot);
+    EXPECT_EQ(snapshot.count, 1000u);
+    EXPECT_EQ(snapshot.max, 1000000u);
+    EXPECT_NEAR(static_cast<double>(snapshot.percentile(0.5)), 500000.0, 500000.0 / 32);
+    EXPECT_NEAR(static_cast<double>(snapshot.percentile(0.99)), 990000.0, 990000.0 / 32);
+    EXPECT_EQ(snapshot.percentile(1.0), 1000000u);
+    EXPECT_EQ(LatencySnapshot().percentile(0.5), 0u);
+}
+
+TEST(LatencyHistogramTest, PerThreadMergeTest) {
+    uint64_t before = latency_snapshot(LatencyStage::Validation).count;
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 500; ++i) {
+                record_latency(LatencyStage::Validation, std::chrono::microseconds(7));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    LatencySnapshot snapshot = latency_snapshot(LatencyStage::Validation);
+    EXPECT_EQ(snapshot.count - before, 2000u);
+    EXPECT_GE(snapshot.max, 7000u);
+    
+    // The book times its own lock wait and matching
+    uint64_t matchedBefore = latency_snapshot(LatencyStage::Matching).count;
+    OrderBook book;
+    book.addOrder(Order(1, intern_symbol("TEST"), Side::Buy, OrderType::Limit, Price::from_double(100.0), 10));
+    EXPECT_EQ(latency_snapshot(LatencyStage::Matching).count, matchedBefore + 1);
+    
+    std::string metrics = latency_metrics_prometheus();
+    EXPECT_NE(metrics.find("# TYPE velocore_latency_nanoseconds summary"), std::string::npos);
+    EXPECT_NE(metrics.find("velocore_latency_nanoseconds{stage=\"validation\",quantile=\"0.99\"}"), std::string::npos);
+    EXPECT_NE(metrics.find("velocore_latency_max_nanoseconds{stage=\"lock_wait\"}"), std::string::npos);
+}
+
+TEST(LoggerTest, FormatAndLevelTest) {
+    EXPECT_EQ(log_level_from_string("debug"), LogLevel::Debug);
+    EXPECT_EQ(log_level_from_string("WARNING"), LogLevel::Warn);
+    EXPECT_EQ(log_level_from_string("nonsense"), LogLevel::Info);
+    
+    Logger& logger = Logger::instance();
+    std::ostringstream output;
+    logger.setSink(output);
+    logger.setLevel(LogLevel::Info);
+    
+    log_debug("hidden");
+    log_info("order ", 42, " for ", intern_symbol("TEST"), " at $", 100.5, " filled=", true, std::string(" ok"));
+    log_error("x", 'y', static_cast<uint64_t>(7), -3);
+    log_info(std::string(1000, 'a'));
+    logger.flush();
+    
+    std::string text = output.str();
+    EXPECT_EQ(text.find("hidden"), std::string::npos);
+    EXPECT_NE(text.find("INFO  order 42 for TEST at $100.5 filled=true ok\n"), std::string::npos);
+    EXPECT_NE(text.find("ERROR xy7-3\n"), std::string::npos);
+    EXPECT_NE(text.find("aaa...\n"), std::string::npos);
+    EXPECT_EQ(text.find(std::string(LogRecord::PAYLOAD_BYTES, 'a')), std::string::npos);
+    
+    logger.setSink(std::cout);
+}
+
+TEST(LoggerTest, ConcurrentProducersTest) {
+    Logger& logger = Logger::instance();
+    std::ostringstream output;
+    logger.setSink(output);
+    logger.setLevel(LogLevel::Info);
+    uint64_t droppedBefore = logger.droppedCount();
+    
+    // Fewer messages per thread than a ring holds, so none are dropped
+    const int threadCount = 4;
+    const int messagesPerThread = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < messagesPerThread; ++i) {
+                log_info("thread ", t, " message ", i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+    logger.setSink(std::cout);
+    
+    EXPECT_EQ(logger.droppedCount(), droppedBefore);
+    std::string text = output.str();
+    for (int t = 0; t < threadCount; ++t) {
+        // Each thread's messages come out in the order it logged them
+        size_t previous = 0;
+        for (int i = 0; i < messagesPerThread; ++i) {
+            std::string line = "thread " + std::to_string(t) + " message " + std::to_string(i) + "\n";
+            size_t position = text.find(line);
+            ASSERT_NE(position, std::string::npos) << line;
+            EXPECT_GE(position, previous);
+            previous = position;
+        }
+    }
+}
+
+TEST(JsonWriterTest, StructureAndEscapingTest) {
+    std::string buffer;
+    JsonWriter writer(buffer);
+    writer.beginObject()
+        .field("text", "quote\" slash\\ line\n tab\t \x01")
+        .field("int", -42)
+        .field("big", std::numeric_limits<uint64_t>::max())
+        .field("double", 100.25)
+        .field("flag", false)
+        .key("nothing").null()
+        .key("list").beginArray().value(1).value(2).beginObject().endObject().beginArray().endArray().endArray()
+        .key("raw").raw("{\"a\":1}")
+        .field("nan", std::nan(""))
+        .endObject();
+    
+    EXPECT_EQ(buffer,
+        "{\"text\":\"quote\\\" slash\\\\ line\\n tab\\t \\u0001\","
+        "\"int\":-42,\"big\":18446744073709551615,\"double\":100.25,\"flag\":false,"
+        "\"nothing\":null,\"list\":[1,2,{},[]],\"raw\":{\"a\":1},\"nan\":null}");
+    
+    // Reusing the buffer keeps its capacity
+    size_t capacity = buffer.capacity();
+    buffer.clear();
+    JsonWriter(buffer).beginArray().value(0.1).endArray();
+    EXPECT_EQ(buffer, "[0.1]");
+    EXPECT_EQ(buffer.capacity(), capacity);
+}
+
+TEST(JsonWriterTest, ModelSerializationTest) {
+    Trade trade(make_trade_id(intern_symbol("TEST"), 7), 11, 12, intern_symbol("TEST"), Price::from_double(100.5), 20);
+    trade.timestamp = {};
+    
+    std::string buffer;
+    JsonWriter writer(buffer);
+    writer.beginArray();
+    trade.write_json(writer);
+    writer.endArray();
+    
+    std::string expected = "[{\"trade_id\":" + std::to_string(trade.trade_id) +
+        ",\"buy_order_id\":11,\"sell_order_id\":12,\"symbol\":\"TEST\",\"price\":100.5,"
+        "\"quantity\":20,\"total_value\":2010,\"timestamp\":0}]";
+    EXPECT_EQ(buffer, expected);
+    
+    OrderBook book;
+    book.addOrder(Order(1, intern_symbol("TEST"), Side::Buy, OrderType::Limit, Price::from_double(99.5), 10));
+    book.addOrder(Order(1, intern_symbol("TEST"), Side::Sell, OrderType::Limit, Price::from_double(100.5), 5));
+    buffer.clear();
+    book.writeBookSnapshot(writer, 5);
+    EXPECT_EQ(buffer,
+        "{\"bids\":[{\"price\":99.5,\"quantity\":10,\"orders\":1}],"
+        "\"asks\":[{\"price\":100.5,\"quantity\":5,\"orders\":1}],"
+        "\"spread\":1,\"best_bid\":99.5,\"best_ask\":100.5}");
+}
+
+TEST(SnapshotCacheTest, VersionedLookupTest) {
+    SnapshotCache cache;
+    SnapshotKey key{intern_symbol("TEST"), 5};
+    SnapshotVersion version{3, 0};
+    
+    EXPECT_EQ(cache.find(key, version), nullptr);
+    auto stored = cache.store(key, version, "{}");
+    ASSERT_NE(cache.find(key, version), nullptr);
+    EXPECT_EQ(cache.find(key, version)->body, "{}");
+    
+    // Another version or view of the same book misses
+    EXPECT_EQ(cache.find(key, SnapshotVersion{4, 0}), nullptr);
+    EXPECT_EQ(cache.find(key, SnapshotVersion{3, 1}), nullptr);
+    EXPECT_EQ(cache.find(SnapshotKey{intern_symbol("TEST"), 10}, version), nullptr);
+    
+    // A newer body gets a new ETag
+    auto newer = cache.store(key, SnapshotVersion{4, 0}, "[]");
+    EXPECT_NE(newer->etag, stored->etag);
+    EXPECT_EQ(cache.find(key, version), nullptr);
+    
+    EXPECT_TRUE(SnapshotCache::matches(newer->etag, newer->etag));
+    EXPECT_TRUE(SnapshotCache::matches(stored->etag + ", W/" + newer->etag, newer->etag));
+    EXPECT_TRUE(SnapshotCache::matches("*", newer->etag));
+    EXPECT_FALSE(SnapshotCache::matches(stored->etag, newer->etag));
+    EXPECT_FALSE(SnapshotCache::matches("", newer->etag));
+}
+
+TEST(SnapshotCacheTest, BookVersionTest) {
+    OrderBook book;
+    uint64_t initial = book.getVersion();
+    
+    Order order(1, intern_symbol("TEST"), Side::Buy, OrderType::Limit, Price::from_double(99.5), 10);
+    book.addOrder(order);
+    uint64_t afterAdd = book.getVersion();
+    EXPECT_GT(afterAdd, initial);
+    
+    // Reads leave the version alone
+    book.getBookStatistics();
+    EXPECT_EQ(book.getVersion(), afterAdd);
+    
+    EXPECT_TRUE(book.cancelOrder(order.id));
+    EXPECT_GT(book.getVersion(), afterAdd);
+}
+
+TEST(OrderEntryProtocolTest, EncodeDecodeTest) {
+    NewOrderMessage order;
+    order.client_order_id = 0x0102030405060708;
+    order.symbol = "AAPL";
+    order.side = Side::Sell;
+    order.type = OrderType::Limit;
+    order.quantity = 300;
+    order.price = Price(-2);
+    
+    uint8_t buffer[ORDER_ENTRY_MAX_MESSAGE_SIZE];
+    ASSERT_EQ(encode(order, buffer), NewOrderMessage::SIZE);
+    
+    // Little-endian fields at fixed offsets
+    EXPECT_EQ(buffer[0], NewOrderMessage::SIZE);
+    EXPECT_EQ(buffer[1], 0);
+    EXPECT_EQ(buffer[2], 0x01);
+    EXPECT_EQ(buffer[4], 0x08);
+    EXPECT_EQ(buffer[11], 0x01);
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(buffer + 12), 4), "AAPL");
+    EXPECT_EQ(buffer[16], 0);
+    EXPECT_EQ(buffer[20], 1);
+    EXPECT_EQ(buffer[24], 300 & 0xFF);
+    EXPECT_EQ(buffer[25], 300 >> 8);
+    EXPECT_EQ(buffer[28], 0xFE);
+    EXPECT_EQ(buffer[35], 0xFF);
+    
+    OrderEntryHeader header;
+    ASSERT_TRUE(decode_header(buffer, header));
+    EXPECT_EQ(header.type, OrderEntryMessageType::NewOrder);
+    NewOrderMessage decoded;
+    ASSERT_TRUE(decode(buffer, decoded));
+    EXPECT_EQ(decoded.client_order_id, order.client_order_id);
+    EXPECT_EQ(decoded.symbol, "AAPL");
+    EXPECT_EQ(decoded.side, Side::Sell);
+    EXPECT_EQ(decoded.quantity, 300u);
+    EXPECT_EQ(decoded.price, Price(-2));
+    
+    FillMessage fill;
+    fill.client_order_id = 7;
+    fill.order_id = 8;
+    fill.trade_id = 9;
+    fill.price = Price(10050);
+    fill.quantity = 25;
+    fill.liquidity = Liquidity::Added;
+    ASSERT_EQ(encode(fill, buffer), FillMessage::SIZE);
+    FillMessage decodedFill;
+    ASSERT_TRUE(decode_header(buffer, header));
+    ASSERT_TRUE(decode(buffer, decodedFill));
+    EXPECT_EQ(decodedFill.trade_id, 9u);
+    EXPECT_EQ(decodedFill.price, Price(10050));
+    EXPECT_EQ(decodedFill.liquidity, Liquidity::Added);
+    
+    // A length that does not match the type, an unknown type or enum value, an oversized symbol
+    buffer[0] = FillMessage::SIZE + 1;
+    EXPECT_FALSE(decode_header(buffer, header));
+    buffer[0] = FillMessage::SIZE;
+    buffer[2] = 0x7F;
+    EXPECT_FALSE(decode_header(buffer, header));
+    buffer[2] = static_cast<uint8_t>(OrderEntryMessageType::Fill);
+    buffer[40] = 0;
+    EXPECT_FALSE(decode(buffer, decodedFill));
+    order.symbol = "TOOLONGSYM";
+    EXPECT_THROW(encode(order, buffer), std::invalid_argument);
+}
+
+TEST(OrderEntryGatewayTest, LoopbackSessionTest) {
+    Logger::instance().setLevel(LogLevel::Warn);
+    Exchange exchange;
+    exchange.getOrCreateBook(intern_symbol("OETEST"));
+    std::atomic<size_t> tradesSeen{0};
+    
+    OrderEntryGateway::Handlers handlers;
+    handlers.findSymbol = [&](const std::string& symbol) { return exchange.findListedSymbol(symbol); };
+    handlers.submitOrder = [&](const Order& order) { return exchange.addOrder(order); };
+    handlers.submitCancel = [&](SymbolId symbol, uint64_t orderId) { return exchange.cancelOrder(symbol, orderId); };
+    handlers.submitAmend = [&](SymbolId symbol, uint64_t orderId, Price newPrice, int newQuantity) {
+        return exchange.amendOrder(symbol, orderId, newPrice, newQuantity);
+    };
+    handlers.findOrder = [&](SymbolId symbol, uint64_t orderId) -> std::optional<Order> {
+        OrderBook* book = exchange.findBook(symbol);
+        return book ? book->findOrder(orderId) : std::nullopt;
+    };
+    handlers.onTrades = [&](const std::vector<Trade>& trades) { tradesSeen += trades.size(); };
+    
+    OrderEntryGateway gateway(std::move(handlers));
+    gateway.start(0);
+    ASSERT_NE(gateway.port(), 0);
+    
+    OrderEntryClient maker;
+    OrderEntryClient taker;
+    maker.connect("127.0.0.1", gateway.port());
+    taker.connect("127.0.0.1", gateway.port());
+    
+    // A resting buy of 10
+    uint64_t makerId = maker.sendNewOrder("OETEST", Side::Buy, OrderType::Limit, Price(10000), 10);
+    auto ack = std::get<AckMessage>(maker.receive());
+    EXPECT_EQ(ack.client_order_id, makerId);
+    EXPECT_EQ(ack.leaves_quantity, 10u);
+    EXPECT_EQ(ack.executed_quantity, 0u);
+    uint64_t restingId = ack.order_id;
+    
+    // Another session may not touch it
+    taker.sendCancel(restingId);
+    auto reject = std::get<RejectMessage>(taker.receive());
+    EXPECT_EQ(reject.reason, RejectReason::UnknownOrder);
+    
+    // A sell of 4 removes liquidity, the buy's session hears about it too
+    uint64_t takerId = taker.sendNewOrder("OETEST", Side::Sell, OrderType::Limit, Price(9900), 4);
+    auto takerAck = std::get<AckMessage>(taker.receive());
+    EXPECT_EQ(takerAck.client_order_id, takerId);
+    EXPECT_EQ(takerAck.executed_quantity, 4u);
+    EXPECT_EQ(takerAck.leaves_quantity, 0u);
+    auto takerFill = std::get<FillMessage>(taker.receive());
+    EXPECT_EQ(takerFill.liquidity, Liquidity::Removed);
+    EXPECT_EQ(takerFill.price, Price(10000));
+    
+    auto makerFill = std::get<FillMessage>(maker.receive());
+    EXPECT_EQ(makerFill.client_order_id, makerId);
+    EXPECT_EQ(makerFill.order_id, restingId);
+    EXPECT_EQ(makerFill.trade_id, takerFill.trade_id);
+    EXPECT_EQ(makerFill.liquidity, Liquidity::Added);
+    EXPECT_EQ(makerFill.quantity, 4u);
+    
+    // Amend to a total of 8 keeps the price, leaving 4 open
+    maker.sendAmend(restingId, Price(0), 8);
+    auto amendAck = std::get<AckMessage>(maker.receive());
+    EXPECT_EQ(amendAck.request, OrderEntryMessageType::Amend);
+    EXPECT_EQ(amendAck.leaves_quantity, 4u);
+    ASSERT_TRUE(exchange.findOrder(restingId).has_value());
+    EXPECT_EQ(exchange.findOrder(restingId)->remaining_quantity, 4);
+    
+    // Trades made over REST reach the resting order's session through reportTrades
+    Order restSell(1, intern_symbol("OETEST"), Side::Sell, OrderType::Limit, Price(10000), 1);
+    gateway.reportTrades(exchange.addOrder(restSell));
+    EXPECT_EQ(std::get<FillMessage>(maker.receive()).quantity, 1u);
+    
+    maker.sendCancel(restingId);
+    auto cancelAck = std::get<AckMessage>(maker.receive());
+    EXPECT_EQ(cancelAck.request, OrderEntryMessageType::Cancel);
+    EXPECT_FALSE(exchange.findOrder(restingId).has_value());
+    
+    // Crossing its own order, a session gets both sides
+    taker.sendNewOrder("OETEST", Side::Buy, OrderType::Limit, Price(10000), 2);
+    EXPECT_EQ(std::get<AckMessage>(taker.receive()).leaves_quantity, 2u);
+    taker.sendNewOrder("OETEST", Side::Sell, OrderType::Limit, Price(10000), 2);
+    EXPECT_EQ(std::get<AckMessage>(taker.receive()).executed_quantity, 2u);
+    EXPECT_EQ(std::get<FillMessage>(taker.receive()).liquidity, Liquidity::Removed);
+    EXPECT_EQ(std::get<FillMessage>(taker.receive()).liquidity, Liquidity::Added);
+    
+    // Invalid requests are rejected without ending the session
+    taker.sendNewOrder("OETEST", Side::Buy, OrderType::Limit, Price(0), 5);
+    EXPECT_EQ(std::get<RejectMessage>(taker.receive()).reason, RejectReason::InvalidPrice);
+    taker.sendNewOrder("OETEST", Side::Buy, OrderType::Market, Price(), 0);
+    EXPECT_EQ(std::get<RejectMessage>(taker.receive()).reason, RejectReason::InvalidQuantity);
+    taker.sendNewOrder("OENOBOOK", Side::Buy, OrderType::Limit, Price(10000), 5);
+    EXPECT_EQ(std::get<RejectMessage>(taker.receive()).reason, RejectReason::InvalidSymbol);
+    EXPECT_TRUE(find_symbol("OENOBOOK").empty());
+    
+    EXPECT_EQ(tradesSeen.load(), 2u);
+    EXPECT_EQ(gateway.getSessionCount(), 2u);
+    
+    maker.close();
+    taker.close();
+    gateway.stop();
+}
+
+TEST(OrderEntryGatewayTest, RestChangesTest) {
+    Logger::instance().setLevel(LogLevel::Warn);
+    Exchange exchange;
+    
+    OrderEntryGateway::Handlers handlers;
+    handlers.findSymbol = [&](const std::string& symbol) { return exchange.findListedSymbol(symbol); };
+    handlers.submitOrder = [&](const Order& order) { return exchange.addOrder(order); };
+    handlers.submitCancel = [&](SymbolId symbol, uint64_t orderId) { return exchange.cancelOrder(symbol, orderId); };
+    handlers.submitAmend = [&](SymbolId symbol, uint64_t orderId, Price newPrice, int newQuantity) {
+        return exchange.amendOrder(symbol, orderId, newPrice, newQuantity);
+    };
+    handlers.findOrder = [&](SymbolId symbol, uint64_t orderId) -> std::optional<Order> {
+        OrderBook* book = exchange.findBook(symbol);
+        return book ? book->findOrder(orderId) : std::nullopt;
+    };
+    
+    OrderEntryGateway gateway(std::move(handlers));
+    gateway.start(0);
+    OrderEntryClient client;
+    client.connect("127.0.0.1", gateway.port());
+    SymbolId symbol = intern_symbol("OEREST");
+    exchange.getOrCreateBook(symbol);
+    
+    client.sendNewOrder("OEREST", Side::Buy, OrderType::Limit, Price(10000), 10);
+    uint64_t orderId = std::get<AckMessage>(client.receive()).order_id;
+    
+    // Amended over REST, then over the gateway keeping the REST price
+    ASSERT_TRUE(exchange.amendOrder(symbol, orderId, Price(10100), 6).has_value());
+    client.sendAmend(orderId, Price(0), 5);
+    EXPECT_EQ(std::get<AckMessage>(client.receive()).leaves_quantity, 5u);
+    ASSERT_TRUE(exchange.findOrder(orderId).has_value());
+    EXPECT_EQ(exchange.findOrder(orderId)->price, Price(10100));
+    
+    // Cancelled over REST, the gateway no longer knows it
+    ASSERT_TRUE(exchange.cancelOrder(symbol, orderId));
+    client.sendAmend(orderId, Price(0), 4);
+    EXPECT_EQ(std::get<RejectMessage>(client.receive()).reason, RejectReason::UnknownOrder);
+    EXPECT_EQ(gateway.getOwnedOrderCount(), 0u);
+    
+    // Orders cancelled over REST are forgotten by the next sweep
+    std::vector<uint64_t> orderIds;
+    for (int i = 0; i < 1100; ++i) {
+        client.sendNewOrder("OEREST", Side::Buy, OrderType::Limit, Price(9000 + i % 100), 1);
+        orderIds.push_back(std::get<AckMessage>(client.receive()).order_id);
+        if (orderIds.size() == 1000) {
+            for (uint64_t id : orderIds) {
+                exchange.cancelOrder(symbol, id);
+            }
+        }
+    }
+    EXPECT_EQ(gateway.getOwnedOrderCount(), 100u);
+    
+    client.close();
+    gateway.stop();
+}
+
+TEST(OrderEntryGatewayTest, NonReadingSessionTest) {
+    Logger::instance().setLevel(LogLevel::Error);
+    Exchange exchange;
+    
+    OrderEntryGateway::Handlers handlers;
+    handlers.findSymbol = [&](const std::string& symbol) { return exchange.findListedSymbol(symbol); };
+    handlers.submitOrder = [&](const Order& order) { return exchange.addOrder(order); };
+    handlers.submitCancel = [&](SymbolId symbol, uint64_t orderId) { return exchange.cancelOrder(symbol, orderId); };
+    handlers.submitAmend = [&](SymbolId symbol, uint64_t orderId, Price newPrice, int newQuantity) {
+        return exchange.amendOrder(symbol, orderId, newPrice, newQuantity);
+    };
+    handlers.findOrder = [&](SymbolId symbol, uint64_t orderId) -> std::optional<Order> {
+        OrderBook* book = exchange.findBook(symbol);
+        return book ? book->findOrder(orderId) : std::nullopt;
+    };
+    
+    exchange.getOrCreateBook(intern_symbol("OESTALL"));
+    OrderEntryGateway gateway(std::move(handlers), 16 * 1024);
+    gateway.start(0);
+    
+    // Sends invalid orders and never reads their Rejects
+    boost::asio::io_context ioContext;
+    boost::asio::ip::tcp::socket stalled(ioContext);
+    stalled.open(boost::asio::ip::tcp::v4());
+    stalled.set_option(boost::asio::socket_base::receive_buffer_size(4096));
+    stalled.connect({boost::asio::ip::make_address("127.0.0.1"), gateway.port()});
+    
+    NewOrderMessage invalid;
+    invalid.symbol = "OESTALL";
+    invalid.side = Side::Buy;
+    invalid.type = OrderType::Limit;
+    invalid.price = Price(10000);
+    invalid.quantity = 0;
+    const size_t BATCH = 1000;
+    std::vector<uint8_t> batch(BATCH * NewOrderMessage::SIZE);
+    for (size_t i = 0; i < BATCH; ++i) {
+        encode(invalid, batch.data() + i * NewOrderMessage::SIZE);
+    }
+    
+    OrderEntryClient other;
+    other.connect("127.0.0.1", gateway.port());
+    
+    bool disconnected = false;
+    for (int sent = 0; sent < 2000 && !disconnected; ++sent) {
+        boost::system::error_code ec;
+        boost::asio::write(stalled, boost::asio::buffer(batch), ec);
+        disconnected = ec || gateway.getSessionCount() == 1;
+    }
+    EXPECT_TRUE(disconnected);
+    
+    // Nobody waited on the stalled client, and other sessions carry on
+    other.sendNewOrder("OESTALL", Side::Buy, OrderType::Limit, Price(10000), 1);
+    EXPECT_TRUE(std::holds_alternative<AckMessage>(other.receive()));
+    
+    other.close();
+    gateway.stop();
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
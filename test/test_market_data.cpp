@@ -43,9 +43,9 @@ protected:
 // =====================================================
 
 TEST_F(MarketDataTest, MarketTickConstructorTest) {
-    MarketTick tick("AAPL", MarketDataType::Trade);
+    MarketTick tick(intern_symbol("AAPL"), MarketDataType::Trade);
     
-    EXPECT_EQ(tick.symbol, "AAPL");
+    EXPECT_EQ(symbol_name(tick.symbol), "AAPL");
     EXPECT_EQ(tick.type, MarketDataType::Trade);
     EXPECT_EQ(tick.trade_price, 0.0);
     EXPECT_EQ(tick.trade_size, 0);
@@ -61,12 +61,12 @@ TEST_F(MarketDataTest, MarketTickConstructorTest) {
 }
 
 TEST_F(MarketDataTest, MarketTickTradeDataTest) {
-    MarketTick tick("AAPL", MarketDataType::Trade);
+    MarketTick tick(intern_symbol("AAPL"), MarketDataType::Trade);
     tick.trade_price = 150.50;
     tick.trade_size = 100;
     tick.timestamp = test_time;
     
-    EXPECT_EQ(tick.symbol, "AAPL");
+    EXPECT_EQ(symbol_name(tick.symbol), "AAPL");
     EXPECT_EQ(tick.type, MarketDataType::Trade);
     EXPECT_DOUBLE_EQ(tick.trade_price, 150.50);
     EXPECT_EQ(tick.trade_size, 100);
@@ -74,14 +74,14 @@ TEST_F(MarketDataTest, MarketTickTradeDataTest) {
 }
 
 TEST_F(MarketDataTest, MarketTickQuoteDataTest) {
-    MarketTick tick("AAPL", MarketDataType::Quote);
+    MarketTick tick(intern_symbol("AAPL"), MarketDataType::Quote);
     tick.bid_price = 150.25;
     tick.ask_price = 150.75;
     tick.bid_size = 200;
     tick.ask_size = 150;
     tick.timestamp = test_time;
     
-    EXPECT_EQ(tick.symbol, "AAPL");
+    EXPECT_EQ(symbol_name(tick.symbol), "AAPL");
     EXPECT_EQ(tick.type, MarketDataType::Quote);
     EXPECT_DOUBLE_EQ(tick.bid_price, 150.25);
     EXPECT_DOUBLE_EQ(tick.ask_price, 150.75);
@@ -91,7 +91,7 @@ TEST_F(MarketDataTest, MarketTickQuoteDataTest) {
 }
 
 TEST_F(MarketDataTest, MarketTickBarDataTest) {
-    MarketTick tick("AAPL", MarketDataType::Bar);
+    MarketTick tick(intern_symbol("AAPL"), MarketDataType::Bar);
     tick.open = 150.00;
     tick.high = 152.00;
     tick.low = 149.50;
@@ -99,7 +99,7 @@ TEST_F(MarketDataTest, MarketTickBarDataTest) {
     tick.volume = 10000;
     tick.timestamp = test_time;
     
-    EXPECT_EQ(tick.symbol, "AAPL");
+    EXPECT_EQ(symbol_name(tick.symbol), "AAPL");
     EXPECT_EQ(tick.type, MarketDataType::Bar);
     EXPECT_DOUBLE_EQ(tick.open, 150.00);
     EXPECT_DOUBLE_EQ(tick.high, 152.00);
@@ -239,7 +239,7 @@ TEST_F(MarketDataTest, ConfigurationGeneralConfigTest) {
 // =====================================================
 
 TEST_F(MarketDataTest, MarketTickJSONSerializationTest) {
-    MarketTick tick("AAPL", MarketDataType::Trade);
+    MarketTick tick(intern_symbol("AAPL"), MarketDataType::Trade);
     tick.trade_price = 150.50;
     tick.trade_size = 100;
     
@@ -330,8 +330,8 @@ TEST_F(MarketDataFeedTest, MarketDataFeedCallbackRegistrationTest) {
         error_callback_called = true;
     });
     
-    MarketTick test_tick("AAPL", MarketDataType::Trade);
-    feed.broadcastBookUpdate("AAPL", test_tick);
+    MarketTick test_tick(intern_symbol("AAPL"), MarketDataType::Trade);
+    feed.broadcastBookUpdate(test_tick.symbol, test_tick);
     
     EXPECT_TRUE(tick_callback_called);
 }
@@ -383,7 +383,7 @@ TEST_F(MarketDataTest, MarketDataIntegrationTest) {
     config.loadFromEnvironment();
     
     // Create a market tick
-    MarketTick tick("AAPL", MarketDataType::Trade);
+    MarketTick tick(intern_symbol("AAPL"), MarketDataType::Trade);
     tick.trade_price = 150.50;
     tick.trade_size = 100;
     
@@ -406,7 +406,7 @@ TEST_F(MarketDataTest, MarketDataPerformanceTest) {
     auto start = std::chrono::high_resolution_clock::now();
     
     for (int i = 0; i < NUM_TICKS; ++i) {
-        MarketTick tick("AAPL", MarketDataType::Trade);
+        MarketTick tick(intern_symbol("AAPL"), MarketDataType::Trade);
         tick.trade_price = 150.0 + (i * 0.01);
         tick.trade_size = 100 + i;
         
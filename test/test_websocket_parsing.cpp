@@ -217,14 +217,14 @@ TEST_F(MarketDataFeedMessageTest, CallbackRegistrationTest) {
     EXPECT_EQ(error_callbacks.size(), 0);
     
     // Test broadcasting
-    MarketTick test_tick("AAPL", MarketDataType::Trade);
+    MarketTick test_tick(intern_symbol("AAPL"), MarketDataType::Trade);
     test_tick.trade_price = 150.50;
     test_tick.trade_size = 100;
     
-    feed->broadcastBookUpdate("AAPL", test_tick);
+    feed->broadcastBookUpdate(test_tick.symbol, test_tick);
     
     EXPECT_EQ(tick_callbacks.size(), 1);
-    EXPECT_EQ(tick_callbacks[0].symbol, "AAPL");
+    EXPECT_EQ(symbol_name(tick_callbacks[0].symbol), "AAPL");
     EXPECT_EQ(tick_callbacks[0].type, MarketDataType::Trade);
     EXPECT_DOUBLE_EQ(tick_callbacks[0].trade_price, 150.50);
     EXPECT_EQ(tick_callbacks[0].trade_size, 100);
@@ -232,28 +232,28 @@ TEST_F(MarketDataFeedMessageTest, CallbackRegistrationTest) {
 
 TEST_F(MarketDataFeedMessageTest, MultipleTicksTest) {
     // Test multiple ticks
-    MarketTick tick1("AAPL", MarketDataType::Trade);
+    MarketTick tick1(intern_symbol("AAPL"), MarketDataType::Trade);
     tick1.trade_price = 150.50;
     tick1.trade_size = 100;
     
-    MarketTick tick2("GOOGL", MarketDataType::Quote);
+    MarketTick tick2(intern_symbol("GOOGL"), MarketDataType::Quote);
     tick2.bid_price = 2800.25;
     tick2.ask_price = 2800.75;
     tick2.bid_size = 50;
     tick2.ask_size = 75;
     
-    feed->broadcastBookUpdate("AAPL", tick1);
-    feed->broadcastBookUpdate("GOOGL", tick2);
+    feed->broadcastBookUpdate(tick1.symbol, tick1);
+    feed->broadcastBookUpdate(tick2.symbol, tick2);
     
     EXPECT_EQ(tick_callbacks.size(), 2);
     
     // Check first tick
-    EXPECT_EQ(tick_callbacks[0].symbol, "AAPL");
+    EXPECT_EQ(symbol_name(tick_callbacks[0].symbol), "AAPL");
     EXPECT_EQ(tick_callbacks[0].type, MarketDataType::Trade);
     EXPECT_DOUBLE_EQ(tick_callbacks[0].trade_price, 150.50);
     
     // Check second tick
-    EXPECT_EQ(tick_callbacks[1].symbol, "GOOGL");
+    EXPECT_EQ(symbol_name(tick_callbacks[1].symbol), "GOOGL");
     EXPECT_EQ(tick_callbacks[1].type, MarketDataType::Quote);
     EXPECT_DOUBLE_EQ(tick_callbacks[1].bid_price, 2800.25);
     EXPECT_DOUBLE_EQ(tick_callbacks[1].ask_price, 2800.75);
@@ -356,11 +356,11 @@ TEST_F(MarketDataFeedMessageTest, CallbackPerformanceTest) {
     auto start = std::chrono::high_resolution_clock::now();
     
     for (int i = 0; i < NUM_TICKS; ++i) {
-        MarketTick tick("AAPL", MarketDataType::Trade);
+        MarketTick tick(intern_symbol("AAPL"), MarketDataType::Trade);
         tick.trade_price = 150.0 + (i * 0.01);
         tick.trade_size = 100 + i;
         
-        feed->broadcastBookUpdate("AAPL", tick);
+        feed->broadcastBookUpdate(tick.symbol, tick);
     }
     
     auto end = std::chrono::high_resolution_clock::now();
@@ -381,12 +381,12 @@ TEST_F(WebSocketParsingTest, AlpacaMessageRoundTripTest) {
     json parsed = json::parse(trade_msg);
     
     // Create MarketTick from parsed data
-    MarketTick tick("AAPL", MarketDataType::Trade);
+    MarketTick tick(intern_symbol("AAPL"), MarketDataType::Trade);
     tick.trade_price = parsed["p"];
     tick.trade_size = parsed["s"];
     
     // Verify the data
-    EXPECT_EQ(tick.symbol, "AAPL");
+    EXPECT_EQ(symbol_name(tick.symbol), "AAPL");
     EXPECT_EQ(tick.type, MarketDataType::Trade);
     EXPECT_DOUBLE_EQ(tick.trade_price, 150.50);
     EXPECT_EQ(tick.trade_size, 100);